@@ -20,8 +20,8 @@ namespace cuba {
 base_cuba::base_cuba(const string& initl, const string& final,
 		const string& filename) :
 		reachable(false), initl_c(0, 1), final_c(0, 1), CPDA(
-				parser::parse_input_cpds(filename)), ///
-		generators(), reachable_T(), ///
+				parser::parse_input_cpds(filename)), CFSM(), ///
+		alpha_ranges(), generators(alpha_ranges), reachable_T(), ///
 		filename_global_R(""), filename_top_R("") {
 	initl_c = parser::parse_input_cfg(initl);
 
@@ -30,8 +30,17 @@ base_cuba::base_cuba(const string& initl, const string& final,
 		flags::OPT_PROB_REACHABILITY = true;
 	}
 
-	generator gen(initl, CPDA, parser::parse_input_cfsm(filename));
-	generators = gen.get_generators();
+	alpha_ranges = compute_alpha_ranges();
+	CFSM = parser::parse_input_cfsm(filename);
+	{
+		stats::timer t(stats::phase::GENERATOR);
+		generator gen(initl, CPDA, CFSM);
+		generators = visible_state_set(alpha_ranges);
+		for (const auto& states : gen.get_generators()) {
+			for (const auto& s : states)
+				generators.insert(s);
+		}
+	}
 
 	if (flags::OPT_FILE_DUMP) {
 		auto idx = filename.find_first_of('.');
@@ -59,5 +68,40 @@ visible_state base_cuba::top_mapping(const explicit_state& tau) {
 	}
 	return visible_state(tau.get_state(), W);
 }
+
+/**
+ * Compute the range of stack symbols of each thread, from its PDA and
+ * its initial stack
+ * @return vector<alpha_range>
+ */
+vector<alpha_range> base_cuba::compute_alpha_ranges() const {
+	vector<alpha_range> ranges;
+	for (size_n i = 0; i < initl_c.get_stacks().size(); ++i) {
+		auto lo = std::numeric_limits<pda_alpha>::max();
+		pda_alpha hi = 0;
+		auto bound = [&lo, &hi](const pda_alpha l) {
+			if (l == alphabet::EPSILON)
+				return;
+			lo = std::min(lo, l);
+			hi = std::max(hi, l);
+		};
+		if (i < CPDA.size()) {
+			for (const auto l : CPDA[i].get_alphas())
+				bound(l);
+			for (const auto& r : CPDA[i].get_actions()) {
+				bound(r.get_src().get_alpha());
+				const auto dst = r.get_dst();
+				for (const auto l : dst.get_stack())
+					bound(l);
+			}
+		}
+		for (const auto l : initl_c.get_stacks()[i])
+			bound(l);
+		if (lo > hi) /// no symbols at all
+			lo = hi = 0;
+		ranges.emplace_back(lo, hi);
+	}
+	return ranges;
+}
 } /* namespace cuba */
 
@@ -10,6 +10,11 @@
 
 #include <flags.hh>
 #include "generator.hh"
+#include "parallel.hh"
+#include "reached.hh"
+#include "stats.hh"
+#include "lru.hh"
+#include "summary.hh"
 
 using namespace ruba;
 
@@ -33,8 +38,12 @@ protected:
 	visible_state final_c;
 	/// concurrent pushdown system
 	concurrent_pushdown_automata CPDA;
+	/// the finite machines over the visible thread states of CPDA
+	concurrent_finite_machine CFSM;
+	/// the range of stack symbols of each thread
+	vector<alpha_range> alpha_ranges;
 	/// generators: used for determining the convergence
-	vector<set<visible_state>> generators;
+	visible_state_set generators;
 	/// used for marking the set of reachable thread states, only supporting
 	/// parameterized system for now
 	vector<vector<bool>> reachable_T;
@@ -45,6 +54,7 @@ protected:
 
 private:
 	visible_state top_mapping(const explicit_state& tau);
+	vector<alpha_range> compute_alpha_ranges() const;
 };
 
 /////////////////////////////////////////////////////////////////////////
@@ -57,11 +67,30 @@ public:
 	~symbolic_cuba();
 
 	virtual void context_unbounded_analysis(const size_k k_bound = 0);
+
+	/// the language inclusion of automata, which decides whether a
+	/// symbolic state is subsumed by another one
+	static bool is_included(const store_automaton& A1,
+			const store_automaton& A2);
+	static bool is_subsumed(const symbolic_state& c1,
+			const symbolic_state& c2);
 private:
+	/// the Post* computed, indexed by the thread and the canonical form
+	/// of the input automaton
+	lru_cache<string, store_automaton> post_cache;
+	/// the lock of post_cache, as Post* is computed by several threads
+	std::mutex post_lock;
+	/// the number of states of the automata minimized, before and after
+	std::atomic<ulong> minimized_from;
+	std::atomic<ulong> minimized_to;
+
+	/// the number of Post* kept in post_cache
+	static const size_t POST_CACHE_SIZE;
 
 	/// Post*(A): build pushdown store automaton
 	store_automaton create_init_automaton(const pushdown_automaton& P,
 			const pda_state q_I, const pda_stack& w);
+	store_automaton post_kleene(const store_automaton& A, const size_n tid);
 	store_automaton post_kleene(const store_automaton& A,
 			const pushdown_automaton& P);
 
@@ -80,10 +109,15 @@ private:
 			const pda_state& q_I);
 	store_automaton anonymize_by_rename(const store_automaton& A,
 			const pda_state& q_I);
+	store_automaton minimize(const store_automaton& A);
 
 	/// determine R_k = R_{k+1}
 	bool is_recongnizable(const store_automaton& A, const thread_state& c);
-	bool is_equivalent(const store_automaton& A1, const store_automaton& A2);
+	string get_signature(const symbolic_state& c);
+	static vector<fsa_state> epsilon_closure(const store_automaton& A,
+			vector<fsa_state> X);
+	static vector<fsa_state> successors(const store_automaton& A,
+			const vector<fsa_state>& X, const fsa_alpha a);
 	store_automaton iunion(const store_automaton& A1,
 			const store_automaton& A2);
 	store_automaton intersect(const store_automaton& A1,
@@ -93,13 +127,14 @@ private:
 
 	/// determine bar(R_k) = bar(R_{k+1})s
 	bool converge(const vector<deque<symbolic_state>>& R, const size_k k,
-			vector<set<visible_state>>& top_R);
+			visible_state_set& top_R);
 	bool is_convergent();
 	uint top_mapping(const deque<symbolic_state>& R,
-			vector<set<visible_state>>& topped_R);
-	vector<visible_state> top_mapping(const symbolic_state& tau);
-	set<pda_alpha> top_mapping(const store_automaton& A, const pda_state q);
-	vector<vector<pda_alpha>> cross_product(const vector<set<pda_alpha>>& tops);
+			visible_state_set& topped_R);
+	bool top_mapping(const symbolic_state& tau,
+			const std::function<bool(const visible_state&)>& f);
+	const set<pda_alpha>& top_mapping(const store_automaton& A,
+			const pda_state q);
 };
 
 /// To store unordering explicit states
@@ -121,35 +156,63 @@ public:
 private:
 	bool k_bounded_reachability(const size_k k_bound,
 			const explicit_state& c_I);
+	bool best_first_reachability(const size_k k_bound,
+			const explicit_state& c_I);
 	antichain step(const explicit_state_tid& tau, const bool is_switch);
 	void step(const pda_state& q, const stack_vec& W, const uint tid,
+			antichain& successors, const bool skip_local = false);
+	void summarize(const pda_state& q, const stack_vec& W, const uint tid,
 			antichain& successors);
-	bool update_R(vector<vector<antichain>>& R, const size_k k,
-			const explicit_state_tid& c);
 
 	/// determine convergence, reachability of a target and so on
-	bool converge(const vector<vector<antichain>>& R, const size_k k,
-			vector<set<visible_state>>& top_R, const bool next_level);
-	uint update_top_R(const vector<vector<antichain>>& R, const size_k k,
-			vector<set<visible_state>>& top_R);
+	bool converge(const reached_set& R, const visible_state_set& tops,
+			const size_k k, visible_state_set& top_R, const bool next_level);
+	uint update_top_R(const reached_set& R, const size_k k,
+			visible_state_set& top_R);
+	uint update_top_R(const visible_state& top_c, visible_state_set& top_R);
 	bool is_convergent();
-	bool is_reachable(const explicit_state_tid& tau, const size_k k,
-			vector<vector<antichain>>& R);
 	void marking(const pda_state& s, const pda_alpha& l);
 
 	visible_state top_mapping(const explicit_state_tid& tau);
+	visible_state top_mapping(const reached_set& R, const packed_state& tau);
+
+	/// the heuristic distance of a state to the target, for the best-first
+	/// search
+	void compute_distances();
+	uint distance(const visible_state& c) const;
+
+	void dump_metrics(const reached_set& global_R,
+			const visible_state_set& top_R) const;
+	void dump_bitstate(const reached_set& global_R) const;
+	void dump_witness(const reached_set& global_R);
+
+	/// save and resume the explicit exploration at the end of a context
+	void save_checkpoint(const size_k k, const antichain& currLevel,
+			const reached_set& global_R, const visible_state_set& top_R,
+			const visible_state_set& tops) const;
+	bool load_checkpoint(size_k& k, antichain& currLevel,
+			reached_set& global_R, visible_state_set& top_R,
+			visible_state_set& tops);
+
+	/// step may run in several threads at the same time
+	std::atomic<uint> number_of_image_calls;
+	std::atomic<uint> number_of_skipped_actions;
+
+	/// the interchangeable threads, if symmetry reduction is enabled
+	symmetry sym;
+
+	/// the procedure summaries, if summarization is enabled
+	summary_table summaries;
 
-	/// determine the finite context reachability
-	bool finite_context_reachability(const size_n tid);
-	bool finite_context_reachability(const pushdown_automaton& PDA,
-			const thread_visible_state& s, stack<pda_alpha>& W,
-			map<thread_visible_state, bool>& visit,
-			map<thread_visible_state, bool>& trace);
+	/// the least number of steps of each thread from each of its visible
+	/// thread states to the top of the target, if best-first search is on
+	vector<map<thread_visible_state, uint>> distances;
 
-	void dump_metrics(const vector<vector<antichain>>& global_R,
-			const vector<set<visible_state>>& top_R) const;
+	/// the problem explored, as recorded in the checkpoints
+	string problem;
 
-	uint number_of_image_calls;
+	/// the largest stack symbol, which decides how reached states are packed
+	pda_alpha max_alpha;
 };
 }
 /* namespace cuba */
@@ -19,8 +19,38 @@ namespace cuba {
  */
 explicit_cuba::explicit_cuba(const string& initl, const string& final,
 		const string& filename) :
-		base_cuba(initl, final, filename), number_of_image_calls(0) {
+		base_cuba(initl, final, filename), number_of_image_calls(0), number_of_skipped_actions(
+				0), sym(), summaries(CPDA), distances(), problem(
+				filename + "\n" + initl + "\n" + final + "\n"), max_alpha(0) {
 	cout << logger::MSG_EXP_EXPLORATION;
+	stats::set_engine("explicit_cuba");
+	/// states, visible states and generators are all replaced by their
+	/// canonical representatives under symmetry
+	if (flags::OPT_SYMMETRY) {
+		sym = symmetry(CPDA, initl_c);
+		for (const auto& c : sym.get_classes()) {
+			cout << "interchangeable threads:";
+			for (const auto i : c)
+				cout << " " << i;
+			cout << "\n";
+		}
+		if (!sym.empty()) {
+			const auto& states = generators.get_states();
+			generators = visible_state_set(alpha_ranges);
+			for (const auto& s : states)
+				generators.insert(sym.canonicalize(s));
+			final_c = sym.canonicalize(final_c);
+		}
+	}
+	/// the largest stack symbol decides how reached states are packed
+	for (const auto& range : alpha_ranges)
+		max_alpha = std::max(max_alpha, range.second);
+	if (flags::OPT_BEST_FIRST)
+		this->compute_distances();
+	/// the options changing the states explored
+	problem += string(flags::OPT_POR ? "r" : "")
+			+ (flags::OPT_SYMMETRY ? "y" : "") + (flags::OPT_SUMMARY ? "u" : "")
+			+ "b" + std::to_string(flags::OPT_BITSTATE);
 }
 
 /**
@@ -36,14 +66,26 @@ explicit_cuba::~explicit_cuba() {
  */
 void explicit_cuba::context_unbounded_analysis(const size_k k_bound) {
 	cout << "context-" << (k_bound == 0 ? "un" : "") << "bounded analysis...\n";
+	/// the finite context reachability of each thread, computed in parallel
+	/// and cached in its PDA
+	{
+		stats::timer t(stats::phase::FCR);
+		parallel::for_each(CPDA.size(), flags::OPT_NUM_THREADS,
+				[this](const size_t tid) {
+					CPDA[tid].is_finite_context();
+				});
+	}
 	for (size_n tid = 0; tid < CPDA.size(); ++tid) {
-		if (finite_context_reachability(tid)) {
+		if (!CPDA[tid].is_finite_context()) {
 			cout << "Finite-context reachability is unsatisfiable...\n";
 			cout << logger::MSG_WARNING << "Please use symbolic CUBA...\n";
 			return;
 		}
 	}
-	const auto convergent = k_bounded_reachability(k_bound, initl_c);
+	const auto convergent =
+			flags::OPT_BEST_FIRST ?
+					best_first_reachability(k_bound, initl_c) :
+					k_bounded_reachability(k_bound, initl_c);
 	if (flags::OPT_PROB_REACHABILITY) {
 		if (reachable)
 			cout << "=> " << final_c << " is reachable!" << endl;
@@ -72,53 +114,114 @@ bool explicit_cuba::k_bounded_reachability(const size_k k_bound,
 	currLevel.emplace_back(CPDA.size(), c_I.get_state(), c_I.get_stacks());
 	/// 1.2 <k>: contexts, k = 0 represented the initial states c_I
 	size_k k = 0;
-	/// 1.3 <global_R>: the sequences of reachable global states.
-	vector<vector<antichain>> global_R;
+	/// 1.3 <global_R>: the sequences of reachable global states, together
+	/// with the hash index mapping each reached global state to the lowest
+	/// context in which it has been reached. The completed contexts are
+	/// spilled to disk if the memory limit is exceeded. In bit-state mode,
+	/// the global states are only hashed into a bit table.
+	reached_set global_R(max_alpha, flags::OPT_MEMORY_LIMIT << 20,
+			flags::OPT_BITSTATE);
 	/// 1.4 <top_R>: the sequences of visible states. We obtained the sequence
 	/// from R directly.
-	vector<set<visible_state>> top_R(thread_visible_state::S,
-			set<visible_state>());
-	global_R.reserve(k_bound + 1);
-	global_R.push_back(vector<antichain>(thread_visible_state::S));
-	global_R.push_back(vector<antichain>(thread_visible_state::S));
-	global_R[k][c_I.get_state()].emplace_back(CPDA.size(), c_I.get_state(),
-			c_I.get_stacks());
+	visible_state_set top_R(alpha_ranges);
+	/// 1.5 <tops>: in bit-state mode, R is not stored, so the visible states
+	/// of R_{k} and of R_{k+1} are collected as the states are reached
+	visible_state_set tops(alpha_ranges), next_tops(alpha_ranges);
+	/// 1.6 resume from the last context saved, if required
+	if (flags::OPT_RESUME
+			&& load_checkpoint(k, currLevel, global_R, top_R, tops)) {
+		cout << "=> resumed at context " << k << "\n";
+	} else {
+		currLevel.front().set_reached(global_R.insert(currLevel.front(), k));
+		if (global_R.is_bitstate())
+			tops.insert(sym.canonicalize(top_mapping(currLevel.front())));
+	}
+	/// 1.7 <block_size>: the number of states in currLevel expanded at a
+	/// time. Successors are merged in the order of currLevel, so the result
+	/// does not depend on the number of threads
+	const size_t block_size =
+			flags::OPT_NUM_THREADS == 1 ? 1 : 256 * flags::OPT_NUM_THREADS;
 	/// step 2: compute all reachable states with up to k_bound contexts.
 	while (k_bound == 0 || k <= k_bound) {
 		/// step 2.0 <nextLevel> = R_{k+1} \ R_{k}: the set of explicit
 		/// states reached in the (k+1)st context. It's initialized
 		/// as empty.
 		antichain nextLevel;
+		/// the states generated and kept in this context, and the image
+		/// calls made before it
+		ulong generated = 0, kept = 0;
+		const ulong image_calls = number_of_image_calls;
 		/// step 2.1: compute nextLevel, or R_{k+1}: iterate over all elements
-		/// in the currLevel. This is a BFS-like procedure.
-		if (k >= global_R.size() || k + 1 >= global_R.size()) {
-			global_R.push_back(vector<antichain>(thread_visible_state::S));
-			global_R.push_back(vector<antichain>(thread_visible_state::S));
-		}
+		/// in the currLevel. This is a BFS-like procedure, which runs in
+		/// rounds: a round expands the states in currLevel, and the states
+		/// it reaches in the kth context are expanded by the next round.
 		while (!currLevel.empty()) {
-			/// 2.1.1: remove an element from currLevel
-			const auto c = currLevel.front();
-			currLevel.pop_front();
-			/// 2.1.3: compute its successors and process them one by one
-			/// The successors without context switch
-			const auto& k_images = step(c, false);
-			for (const auto& _c : k_images) {
-				/// 2.1.4: skip _c if it's already been reached
-				if (!update_R(global_R, k, _c))
-					continue;
-				/// 2.1.5: add _c to worklist if it's not reached yet
-				currLevel.emplace_back(_c);
-			}
-			/// The successors with context switch
-			const auto& k_plus_images = step(c, true);
-			for (const auto& _c : k_plus_images) {
-				/// 2.1.4: skip _c if it's already been reached
-				if (!update_R(global_R, k + 1, _c))
-					continue;
-				/// 2.1.5: add _c to worklist if it's unreachable
-				nextLevel.emplace_back(_c);
+			stats::timer t(stats::phase::EXPANSION, k);
+			/// 2.1.1: spill the first k contexts if the memory limit is
+			/// exceeded, and drop the states in currLevel reached there
+			global_R.spill(k);
+			global_R.filter(currLevel);
+			antichain round;
+			round.swap(currLevel);
+			while (!round.empty()) {
+				/// 2.1.2: remove a block of elements from the round
+				const auto n = std::min(round.size(), block_size);
+				const vector<explicit_state_tid> block(round.begin(),
+						round.begin() + n);
+				round.erase(round.begin(), round.begin() + n);
+				/// 2.1.3: compute their successors, in parallel if required.
+				/// The successors without and with context switch
+				/// respectively
+				vector<antichain> k_images(n), k_plus_images(n);
+				parallel::for_each(n, flags::OPT_NUM_THREADS,
+						[&](const size_t i) {
+							k_images[i] = step(block[i], false);
+							k_plus_images[i] = step(block[i], true);
+						});
+				/// 2.1.4: process the successors one by one, in the same
+				/// order as a sequential exploration does
+				for (size_t i = 0; i < n; ++i) {
+					const auto parent = block[i].get_reached();
+					generated += k_images[i].size() + k_plus_images[i].size();
+					for (auto& _c : k_images[i]) {
+						/// 2.1.5: skip _c if it's already been reached
+						const auto p = global_R.insert(_c, k, parent,
+								_c.get_thread_id(), _c.get_action());
+						if (p == nullptr)
+							continue;
+						++kept;
+						if (global_R.is_bitstate())
+							tops.insert(sym.canonicalize(top_mapping(_c)));
+						/// 2.1.6: add _c to worklist if it's not reached yet
+						_c.set_reached(p);
+						currLevel.emplace_back(_c);
+					}
+					for (auto& _c : k_plus_images[i]) {
+						/// 2.1.5: skip _c if it's already been reached
+						const auto p = global_R.insert(_c, k + 1, parent,
+								_c.get_thread_id(), _c.get_action());
+						if (p == nullptr)
+							continue;
+						++kept;
+						if (global_R.is_bitstate())
+							next_tops.insert(sym.canonicalize(top_mapping(_c)));
+						/// 2.1.6: add _c to worklist if it's unreachable
+						_c.set_reached(p);
+						nextLevel.emplace_back(_c);
+					}
+				}
 			}
 		}
+		/// 2.1.7: drop the states in R_{k+1} that were reached again in
+		/// the kth context or in the spilled contexts
+		{
+			stats::timer t(stats::phase::EXPANSION, k);
+			global_R.compact(k + 1);
+			global_R.filter(nextLevel);
+			global_R.purge();
+		}
+		stats::count(k, generated, kept, number_of_image_calls - image_calls);
+		stats::set_frontier(k, nextLevel.size());
 
 		/// if convergence detection is required, then
 		/// step 2.2: convergence detection
@@ -130,11 +233,13 @@ bool explicit_cuba::k_bounded_reachability(const size_k k_bound,
 //			}
 //		}
 		///  2.2.2: OS3 collapses, i.e. T(R)
-		if (converge(global_R, k, top_R, nextLevel.empty())) {
+		if (converge(global_R, tops, k, top_R, nextLevel.empty())) {
 			if (k_bound == 0) {
 				cout << logger::MSG_TR_COLLAPSE_AT_K
 						<< (k == 0 ? k : k - (nextLevel.empty() ? 2 : 1))
 						<< "\n";
+				if (reachable && !flags::OPT_WITNESS.empty())
+					this->dump_witness(global_R);
 				this->dump_metrics(global_R, top_R);
 				return true;
 			}
@@ -143,14 +248,147 @@ bool explicit_cuba::k_bounded_reachability(const size_k k_bound,
 		if (flags::OPT_PROB_REACHABILITY && reachable) {
 			break;
 		}
+		/// in bit-state mode, the omitted states may keep T(R) from
+		/// converging, so the exploration stops once no state is left
+		if (global_R.is_bitstate() && nextLevel.empty()) {
+			cout << "=> bit-state exploration exhausted at " << k << "\n";
+			break;
+		}
 		/// step 2.3: if all states in currLevel have been processed,
 		/// then move onto the (k+1)st contexts.
 		currLevel.swap(nextLevel), ++k;
+		if (global_R.is_bitstate()) {
+			tops = std::move(next_tops);
+			next_tops = visible_state_set(alpha_ranges);
+		}
+		/// step 2.4: save the contexts explored so far, if required
+		if (!flags::OPT_CHECKPOINT.empty())
+			this->save_checkpoint(k, currLevel, global_R, top_R, tops);
 	}
-
+	if (reachable && !flags::OPT_WITNESS.empty())
+		this->dump_witness(global_R);
+	if (global_R.is_bitstate())
+		this->dump_bitstate(global_R);
 	return false;
 }
 
+/**
+ * This procedure searches for the target visible state among the states
+ * reachable with up to k_bound contexts, expanding first the states which
+ * are the closest to the target by the heuristic distance. It stops as
+ * soon as the target is reached. Each state carries the number of contexts
+ * in which it has been reached: a state reached again with fewer contexts
+ * is expanded again, and its former copy is skipped. It returns true if
+ * all reachable states have been explored, false otherwise.
+ *
+ * @param k_bound: the upper bound of contexts
+ * @param c_I    : the initial global states
+ * @return bool
+ */
+bool explicit_cuba::best_first_reachability(const size_k k_bound,
+		const explicit_state& c_I) {
+	/// step 1: set the data structures that used in the search
+	/// 1.1 <global_R>: the reachable global states, with the lowest context
+	/// in which each has been reached. Nothing is spilled: the frontier
+	/// is not explored level by level.
+	reached_set global_R(max_alpha, 0, flags::OPT_BITSTATE);
+	/// 1.2 <top_R>: the reachable visible states
+	visible_state_set top_R(alpha_ranges);
+	/// 1.3 <frontier>: the states to be expanded, ordered by the distance
+	/// to the target, then by contexts, then by the order of reaching
+	struct entry {
+		uint h;
+		size_k k;
+		ulong order;
+		explicit_state_tid c;
+	};
+	auto is_after = [](const entry& e1, const entry& e2) {
+		if (e1.h != e2.h)
+			return e1.h > e2.h;
+		if (e1.k != e2.k)
+			return e1.k > e2.k;
+		return e1.order > e2.order;
+	};
+	std::priority_queue<entry, vector<entry>, decltype(is_after)> frontier(
+			is_after);
+	ulong order = 0;
+	/// 1.4 <k_target>: the number of contexts in which the target is reached
+	size_k k_target = 0;
+	/// 1.5 <counts>: the states generated and kept, and the image calls,
+	/// per context. The search is not run level by level, so its time is
+	/// reported at level 0.
+	stats::timer t(stats::phase::EXPANSION);
+	struct level_count {
+		ulong generated, kept, image_calls;
+	};
+	vector<level_count> counts;
+	auto count = [&](const size_k k) -> level_count& {
+		if (k >= counts.size())
+			counts.resize(k + 1, level_count { 0, 0, 0 });
+		return counts[k];
+	};
+	/// add _c, reached from parent with k contexts, to the frontier if
+	/// it's new
+	auto reach = [&](explicit_state_tid _c, const size_k k,
+			const packed_state* parent) {
+		++count(k).generated;
+		const auto p = global_R.insert(_c, k, parent, _c.get_thread_id(),
+				_c.get_action());
+		if (p == nullptr)
+			return;
+		++count(k).kept;
+		const auto& top_c = sym.canonicalize(top_mapping(_c));
+		update_top_R(top_c, top_R);
+		if (reachable) {
+			k_target = k;
+			return;
+		}
+		_c.set_context_k(k);
+		_c.set_reached(p);
+		frontier.push(entry { distance(top_c), k, order++, std::move(_c) });
+	};
+	reach(explicit_state_tid(CPDA.size(), c_I.get_state(), c_I.get_stacks()),
+			0, nullptr);
+
+	/// step 2: expand the closest state until the target is reached
+	while (!frontier.empty() && !reachable) {
+		const auto e = frontier.top();
+		frontier.pop();
+		/// 2.1: skip e if its state has been reached with fewer contexts
+		/// since e was added
+		if (global_R.is_reached_below(e.c, e.k))
+			continue;
+		/// 2.2: the successors without context switch stay in context k,
+		/// and those with context switch go to context k + 1
+		++count(e.k).image_calls;
+		for (auto& _c : step(e.c, false)) {
+			reach(std::move(_c), e.k, e.c.get_reached());
+			if (reachable)
+				break;
+		}
+		if (reachable || (k_bound > 0 && e.k >= k_bound))
+			continue;
+		++count(e.k).image_calls;
+		for (auto& _c : step(e.c, true)) {
+			reach(std::move(_c), e.k + 1, e.c.get_reached());
+			if (reachable)
+				break;
+		}
+	}
+	for (size_k k = 0; k < counts.size(); ++k)
+		stats::count(k, counts[k].generated, counts[k].kept,
+				counts[k].image_calls);
+	stats::set_frontier(0, frontier.size());
+	if (reachable) {
+		cout << "=> the target is reached with " << k_target << " contexts\n";
+		if (!flags::OPT_WITNESS.empty())
+			this->dump_witness(global_R);
+	}
+	this->dump_metrics(global_R, top_R);
+	/// the states omitted by the bit-state table may reach the target
+	return !reachable && k_bound == 0 && !global_R.is_bitstate();
+}
+
 /**
  * Step forward, to compute the direct successors of tau. It returns a list
  * of successors, aka. global states
@@ -166,8 +404,13 @@ antichain explicit_cuba::step(const explicit_state_tid& tau,
 	const auto& W = tau.get_stacks(); /// the stacks of tau
 	/// step 2:
 	if (!is_switch) {
-		/// step 2.1: Obtain the successors without any context switch
-		step(q, W, tau.get_thread_id(), successors);
+		/// step 2.1: Obtain the successors without any context switch. With
+		/// procedure summaries, they are all obtained at once, except for
+		/// the states that were themselves obtained from a summary
+		if (!flags::OPT_SUMMARY)
+			step(q, W, tau.get_thread_id(), successors);
+		else if (!tau.is_summarized())
+			summarize(q, W, tau.get_thread_id(), successors);
 	} else {
 		/// step 2.2: Obtain the successors with any context switch. So, the
 		/// algorithm iterates over all threads but the one producing tau
@@ -178,10 +421,28 @@ antichain explicit_cuba::step(const explicit_state_tid& tau,
 			/// is empty. Need to revisit
 			if (tid == tau.get_thread_id())
 				continue;
-			/// step 2.2.2: add successors obtained by performing thread tid
-			step(q, W, tid, successors);
+			/// step 2.2.2: add successors obtained by performing thread tid.
+			/// With POR, if tau was reached by preempting thread tid with
+			/// an action preserving q, then the actions of tid preserving q
+			/// are skipped: running them before the preemption reaches the
+			/// same states with one context less.
+			const auto first = successors.size();
+			step(q, W, tid, successors,
+					flags::OPT_POR && tid == tau.get_preempted());
+			/// step 2.2.3: mark the successors reached by preempting the
+			/// thread of tau with an action preserving q
+			if (flags::OPT_POR) {
+				for (auto i = first; i < successors.size(); ++i) {
+					if (successors[i].get_state() == q)
+						successors[i].set_preempted(tau.get_thread_id());
+				}
+			}
 		}
 	}
+	if (!sym.empty()) {
+		for (auto& _tau : successors)
+			_tau = sym.canonicalize(_tau);
+	}
 	++number_of_image_calls;
 	return successors; /// the set of successors of tau
 }
@@ -193,40 +454,41 @@ antichain explicit_cuba::step(const explicit_state_tid& tau,
  * @param W a stack for thread tid
  * @param tid thread ID
  * @param successors to store all successors
+ * @param skip_local whether to skip the actions preserving q
  */
 void explicit_cuba::step(const pda_state& q, const stack_vec& W, const uint tid,
-		antichain& successors) {
+		antichain& successors, const bool skip_local) {
 	if (tid >= CPDA.size() || W[tid].empty())
 		return;
 	/// step 2.2: iterator over all successors of current thread state
-	const thread_visible_state src(q, W[tid].top());
-	const auto ifind = CPDA[tid].get_program().find(src);
-	if (ifind == CPDA[tid].get_program().end())
-		return;
-	for (const auto rid : ifind->second) { /// rid: transition id
-		const auto& r = CPDA[tid].get_actions()[rid];
-		const auto& dst = r.get_dst();
-
-		auto _W = W; /// duplicate the stacks in current global conf.
+	for (const auto& m : CPDA[tid].get_moves(q, W[tid].top())) {
+		if (skip_local && m.dst == q) {
+			++number_of_skipped_actions;
+			continue;
+		}
+		auto _W = W; /// share the stacks in current global conf.
 
-		switch (r.get_oper_type()) {
+		switch (m.op) {
 		case type_stack_operation::PUSH: { /// push operation
 			_W[tid].pop();
-			for (auto is = dst.get_stack().get_worklist().rbegin();
-					is != dst.get_stack().get_worklist().rend(); ++is) {
-				_W[tid].push(*is);
-			}
-			successors.emplace_back(tid, dst.get_state(), _W);
+			_W[tid].push(m.below);
+			_W[tid].push(m.top);
+			successors.emplace_back(tid, m.dst, _W);
+			successors.back().set_action(m.id);
 		}
 			break;
 		case type_stack_operation::POP: { /// pop operation
-			if (_W[tid].pop())
-				successors.emplace_back(tid, dst.get_state(), _W);
+			if (_W[tid].pop()) {
+				successors.emplace_back(tid, m.dst, _W);
+				successors.back().set_action(m.id);
+			}
 		}
 			break;
 		default: { /// overwrite operation
-			if (_W[tid].overwrite(dst.get_stack().top()))
-				successors.emplace_back(tid, dst.get_state(), _W);
+			if (_W[tid].overwrite(m.top)) {
+				successors.emplace_back(tid, m.dst, _W);
+				successors.back().set_action(m.id);
+			}
 		}
 			break;
 		}
@@ -234,40 +496,64 @@ void explicit_cuba::step(const pda_state& q, const stack_vec& W, const uint tid,
 }
 
 /**
- * Insert explicit_state_tid c to the set of reachable global states R.
- * It returns false if explicit_state_tid c has been reached, and true
- * otherwise.
- * @param R
- * @param k
- * @param c
- * @return bool
+ * Compute all of the states reachable from (q | W) by executing the thread
+ * identified by tid in the same context, by the summary of the procedure
+ * on top of its stack. The states reached before the procedure returns
+ * are marked as summarized: their successors in the same context are
+ * among them, or among the returns.
+ * @param q a shared state
+ * @param W a stack for thread tid
+ * @param tid thread ID
+ * @param successors to store all successors
  */
-bool explicit_cuba::update_R(vector<vector<antichain>>& R, const size_k k,
-		const explicit_state_tid& c) {
-	/// step 2.1.2: discard it if tau is already explored
-	if (is_reachable(c, k, R))
-		return false;
-	R[k][c.get_state()].emplace_back(c);
-	return true;
+void explicit_cuba::summarize(const pda_state& q, const stack_vec& W,
+		const uint tid, antichain& successors) {
+	if (tid >= CPDA.size() || W[tid].empty())
+		return;
+	const auto& s = summaries.get(tid, q, W[tid].top());
+	auto w = W[tid]; /// the stack below the procedure
+	w.pop();
+	auto _W = W;
+	for (const auto& c : s->inner) {
+		_W[tid] = w;
+		_W[tid].push(c.second);
+		successors.emplace_back(tid, c.first, _W);
+		successors.back().set_summarized(true);
+	}
+	_W[tid] = w;
+	for (const auto _q : s->exits)
+		successors.emplace_back(tid, _q, _W);
 }
 
 /**
  * Determine whether reaching a convergence in k contexts. It returns true
  * if converges, false otherwise.
  * @param R  the global states reached in first k contexts.
+ * @param tops the visible states of R_k, if R is a bit-state table
  * @param k  current context is k
  * @param top_R the set of reachable visible states
  * @return bool
  */
-bool explicit_cuba::converge(const vector<vector<antichain>>& R, const size_k k,
-		vector<set<visible_state>>& top_R, const bool next_level) {
+bool explicit_cuba::converge(const reached_set& R,
+		const visible_state_set& tops, const size_k k,
+		visible_state_set& top_R, const bool next_level) {
 //	cout << logger::MSG_SEPARATOR;
 //	cout << "context " << k << "\n";
-	uint cnt_new_top_cfg = update_top_R(R, k, top_R);
+	uint cnt_new_top_cfg = 0;
+	{
+		stats::timer t(stats::phase::TOP_MAPPING, k);
+		if (R.is_bitstate()) {
+			for (const auto& top_c : tops.get_states())
+				cnt_new_top_cfg += update_top_R(top_c, top_R);
+		} else {
+			cnt_new_top_cfg = update_top_R(R, k, top_R);
+		}
+	}
 //	cout << logger::MSG_NUM_VISIBLE_STATES << cnt_new_top_cfg << "\n";
 	if (cnt_new_top_cfg == 0) {
 		cout << logger::MSG_TR_PLATEAU_AT_K << (k - (next_level ? 2 : 1))
 				<< "\n";
+		stats::timer t(stats::phase::CONVERGENCE, k);
 		if (is_convergent()) {
 			return true;
 		}
@@ -275,31 +561,15 @@ bool explicit_cuba::converge(const vector<vector<antichain>>& R, const size_k k,
 	return false;
 }
 
-uint explicit_cuba::update_top_R(const vector<vector<antichain>>& R,
-		const size_k k, vector<set<visible_state>>& top_R) {
+uint explicit_cuba::update_top_R(const reached_set& R, const size_k k,
+		visible_state_set& top_R) {
 	/// the number of new reachable top states
 	uint cnt_new_top_cfg = 0;
 	for (uint q = 0; q < (uint) thread_visible_state::S; ++q) {
-		for (const auto& c : R[k][q]) {
+		for (const auto c : R.get_level(k)[q]) {
 //			if (flags::OPT_PRINT_ALL)
 //				cout << "  " << c;
-			const auto& top_c = top_mapping(c);
-
-			/// if reachability and the target visible state is reachable
-			if (flags::OPT_PROB_REACHABILITY && top_c == final_c) {
-				reachable = true;
-			}
-			const auto& ret = top_R[c.get_state()].emplace(top_c);
-			if (ret.second) {
-//				if (flags::OPT_PRINT_ALL)
-//					cout << " : " << top_c;
-				/// find a new top state
-				++cnt_new_top_cfg;
-				/// updating approx_X
-				auto ifind = generators[top_c.get_state()].find(top_c);
-				if (ifind != generators[top_c.get_state()].end())
-					generators[top_c.get_state()].erase(ifind);
-			}
+			cnt_new_top_cfg += update_top_R(top_mapping(R, *c), top_R);
 //			if (flags::OPT_PRINT_ALL)
 //				cout << "\n";
 		}
@@ -308,56 +578,36 @@ uint explicit_cuba::update_top_R(const vector<vector<antichain>>& R,
 }
 
 /**
- * Determine if OS3 converges or not. Return true if OS3 converges, and
- * false otherwise.
- * @return bool
+ * Add the visible state top_c of a reached state to top_R. It returns 1
+ * if top_c is new, and 0 otherwise.
+ * @param top_c
+ * @param top_R
+ * @return uint
  */
-bool explicit_cuba::is_convergent() {
-	for (const auto& s : generators) {
-		if (!s.empty()) {
-			return false;
-		}
+uint explicit_cuba::update_top_R(const visible_state& top_c,
+		visible_state_set& top_R) {
+	/// if reachability and the target visible state is reachable
+	if (flags::OPT_PROB_REACHABILITY && top_c == final_c) {
+		reachable = true;
 	}
-	return true;
+	if (top_R.insert(top_c)) {
+//		if (flags::OPT_PRINT_ALL)
+//			cout << " : " << top_c;
+		/// updating approx_X
+		generators.erase(top_c);
+		/// find a new top state
+		return 1;
+	}
+	return 0;
 }
 
 /**
- * This procedure is to determine whether there exists c \in R such that
- * (1) c.id == tau.id /\ c.s == c.s /\ c.W == tau.W /\ c.k <= tau.k.
- * It returns true if any of above conditions satisfies. Otherwise, it
- * returns false.
- *
- * (2) One special case is that: there exists c \in R such that
- * c.id == tau.id /\ c.s == tau.s /\ c.W == tau.W /\ c.k > tau.k,
- * then, c is removed.
- *
- * In the implementation, we first check condition (1) and then (2).
- *
- * @param tau
- * @param curr_k
- * @param R
+ * Determine if OS3 converges or not. Return true if OS3 converges, and
+ * false otherwise.
  * @return bool
  */
-bool explicit_cuba::is_reachable(const explicit_state_tid& tau,
-		const size_k curr_k, vector<vector<antichain>>& R) {
-	/// step 1: retrieve the shared state of tau
-	const auto& q = tau.get_state();
-	/// step 2: check condition 3
-	for (uint j = curr_k + 1; j < R.size(); ++j) {
-		for (uint i = 0; i < R[j][q].size(); ++i) {
-			if (R[j][q][i] == tau)
-				R[j][q].erase(R[j][q].begin() + i);
-		}
-	}
-
-	/// step 3: check condition (1) and (2)
-	for (uint j = 0; j <= curr_k && j < R.size(); ++j) {
-		for (uint i = 0; i < R[j][q].size(); ++i) {
-			if (R[j][q][i] == tau)
-				return true;
-		}
-	}
-	return false;
+bool explicit_cuba::is_convergent() {
+	return generators.empty();
 }
 
 /**
@@ -387,100 +637,95 @@ visible_state explicit_cuba::top_mapping(const explicit_state_tid& tau) {
 }
 
 /**
- * This procedure implements the finite context reachability.
- * @param tid
- * @return bool
+ * Extract the visible state of a reached state
+ * @param R the reached set tau is stored in
+ * @param tau
+ * @return visible_state
  */
-bool explicit_cuba::finite_context_reachability(const size_n tid) {
-	const auto& PDA = CPDA[tid];
-	map<thread_visible_state, bool> visit;
-	map<thread_visible_state, bool> trace;
-	for (const auto& p : PDA.get_program()) {
-		visit[p.first] = false;
-		trace[p.first] = false;
-	}
-
-	for (const auto& p : PDA.get_program()) {
-		stack<pda_alpha> W;
-		W.push(p.first.get_alpha());
-		if (!visit[p.first]
-				&& finite_context_reachability(PDA, p.first, W, visit, trace)) {
-			return true;
-		}
-	}
-	return false;
+visible_state explicit_cuba::top_mapping(const reached_set& R,
+		const packed_state& tau) {
+	return sym.canonicalize(R.top(tau));
 }
 
 /**
- * A subrontine of FCR: call by finite_context_reachability(const size_n tid).
- * @param tid
- * @param s
- * @param W
- * @param visit
- * @param trace
- * @return
+ * Compute, for each thread, the least number of steps of its finite
+ * machine from each visible thread state to a visible thread state with
+ * the target's top: a backward BFS from all of the latter ones.
  */
-bool explicit_cuba::finite_context_reachability(const pushdown_automaton& PDA,
-		const thread_visible_state& s, stack<pda_alpha>& W,
-		map<thread_visible_state, bool>& visit,
-		map<thread_visible_state, bool>& trace) {
-	visit[s] = true;
-	trace[s] = true;
-	auto ifind = PDA.get_program().find(s);
-	if (ifind != PDA.get_program().end()) {
-		for (const auto rid : ifind->second) {
-			const auto& r = PDA.get_actions()[rid];
-			const auto& dst = r.get_dst();
-			if (!W.empty())
-				W.pop();
-			switch (r.get_oper_type()) {
-			case type_stack_operation::PUSH: {
-				W.push(dst.get_stack().get_worklist()[1]);
-				W.push(dst.get_stack().get_worklist()[0]);
-			}
-				break;
-			case type_stack_operation::OVERWRITE: {
-				if (!dst.get_stack().empty())
-					W.push(dst.get_stack().top());
-			}
-				break;
-			default: {
-			}
-				break;
+void explicit_cuba::compute_distances() {
+	distances.assign(CFSM.size(), map<thread_visible_state, uint>());
+	for (size_n i = 0; i < CFSM.size() && i < final_c.get_local().size();
+			++i) {
+		const auto& l_f = final_c.get_local()[i];
+		map<thread_visible_state, deque<thread_visible_state>> predecessors;
+		deque<thread_visible_state> worklist;
+		auto visit = [&](const thread_visible_state& s, const uint d) {
+			if (distances[i].emplace(s, d).second)
+				worklist.emplace_back(s);
+		};
+		for (const auto& p : CFSM[i]) {
+			for (const auto& r : p.second) {
+				predecessors[r.get_dst()].emplace_back(p.first);
+				if (r.get_dst().get_alpha() == l_f)
+					visit(r.get_dst(), 0);
 			}
-			if (W.empty())
+			if (p.first.get_alpha() == l_f)
+				visit(p.first, 0);
+		}
+		while (!worklist.empty()) {
+			const auto s = worklist.front();
+			worklist.pop_front();
+			const auto d = distances[i].at(s);
+			auto ifind = predecessors.find(s);
+			if (ifind == predecessors.end())
 				continue;
-			thread_visible_state t(dst.get_state(), W.top());
-			if (!visit[t]
-					&& finite_context_reachability(PDA, t, W, visit, trace)) {
-				return true;
-			} else if (trace[t]) {
-				if (W.size() > 1)
-					return true;
-			}
+			for (const auto& _s : ifind->second)
+				visit(_s, d + 1);
 		}
 	}
-	trace[s] = false;
-	return false;
 }
 
-void explicit_cuba::dump_metrics(const vector<vector<antichain>>& global_R,
-		const vector<set<visible_state>>& top_R) const {
-	cout << logger::MSG_SEPARATOR;
-	ulong size_of_top_R = 0;
-	for (const auto& visible_states : top_R) {
-		size_of_top_R += visible_states.size();
-	}
-	cout << "The number of reachable visible states: " << size_of_top_R << "\n";
-	ulong size_of_R = 0;
-	for (const auto& global_R_k : global_R) {
-		for (const auto& concrete_states : global_R_k) {
-			size_of_R += concrete_states.size();
-		}
+/**
+ * The heuristic distance of a visible state to the target: 1 if its shared
+ * state differs from the target's, plus the distance of each thread to the
+ * target's top. A thread which cannot reach the target's top is given a
+ * large distance, so that its states are expanded last.
+ * @param c
+ * @return uint
+ */
+uint explicit_cuba::distance(const visible_state& c) const {
+	const uint unreachable = 1 << 16;
+	uint d = c.get_state() == final_c.get_state() ? 0 : 1;
+	for (size_n i = 0; i < distances.size() && i < c.get_local().size()
+			&& i < final_c.get_local().size(); ++i) {
+		if (c.get_local()[i] == final_c.get_local()[i])
+			continue;
+		auto ifind = distances[i].find(
+				thread_visible_state(c.get_state(), c.get_local()[i]));
+		d += ifind == distances[i].end() ? unreachable : ifind->second;
 	}
-	cout << "The number of reachable concrete states: " << size_of_R << "\n";
+	return d;
+}
+
+void explicit_cuba::dump_metrics(const reached_set& global_R,
+		const visible_state_set& top_R) const {
+	cout << logger::MSG_SEPARATOR;
+	cout << "The number of reachable visible states: " << top_R.size() << "\n";
+	cout << "The number of reachable concrete states: " << global_R.size()
+			<< "\n";
+	if (flags::OPT_MEMORY_LIMIT > 0)
+		cout << "The number of concrete states spilled to disk: "
+				<< global_R.get_spilled_size() << "\n";
 	cout << "The number of image calls in analysis: "
 			<< get_number_of_image_calls() << "\n";
+	if (flags::OPT_POR)
+		cout << "The number of actions skipped by POR: "
+				<< number_of_skipped_actions << "\n";
+	if (flags::OPT_SUMMARY)
+		cout << "The number of procedure summaries: " << summaries.size()
+				<< "\n";
+	if (global_R.is_bitstate())
+		this->dump_bitstate(global_R);
 
 	if (flags::OPT_FILE_DUMP) {
 //		ofstream osR(filename_global_R);
@@ -496,16 +741,223 @@ void explicit_cuba::dump_metrics(const vector<vector<antichain>>& global_R,
 
 		ofstream osTR(filename_top_R);
 		if (osTR.is_open()) {
-			for (int k = 0; k < top_R.size(); ++k) {
-				for (const auto& t : top_R[k]) {
-					osTR << t << "\n";
-				}
+			for (const auto& t : top_R.get_states()) {
+				osTR << t << "\n";
 			}
 			osTR.close();
 		}
 	}
 }
 
+/**
+ * Report the quality of the bit-state exploration: the fill ratio of the
+ * bit table, and the estimated probability of omitting a new state
+ * @param global_R
+ */
+void explicit_cuba::dump_bitstate(const reached_set& global_R) const {
+	cout << "The fill ratio of the bit-state table: "
+			<< global_R.get_fill_ratio() << "\n";
+	cout << "The estimated probability of omitting a state: "
+			<< global_R.get_omission_probability() << "\n";
+}
+
+/**
+ * Print a witness of the reachability of the target: the path from the
+ * initial state to a reached state of the target in the lowest context,
+ * rebuilt from the back-pointers of the reached states. Each step gives
+ * the context, the thread and the action taken; a step taken in a new
+ * context marks a context switch. The path is printed as text, or as json
+ * if required.
+ * @param global_R
+ */
+void explicit_cuba::dump_witness(const reached_set& global_R) {
+	/// step 1: find a reached state of the target in the lowest context
+	const packed_state* target = nullptr;
+	for (size_k k = 0; k < global_R.get_levels() && target == nullptr; ++k) {
+		for (const auto c : global_R.get_level(k)[final_c.get_state()]) {
+			if (top_mapping(global_R, *c) == final_c) {
+				target = c;
+				break;
+			}
+		}
+	}
+	if (target == nullptr)
+		return;
+	/// step 2: follow the back-pointers to the initial state
+	deque<const packed_state*> path;
+	for (auto c = target; c != nullptr; c = global_R.get_info(*c).parent)
+		path.emplace_front(c);
+	/// the rule of the action of a step, if it's taken by one action
+	auto rule = [this](const reached_info& info) {
+		std::ostringstream os;
+		if (info.action == explicit_state_tid::NO_ACTION)
+			os << "summary";
+		else
+			os << CPDA[info.tid].get_actions()[info.action];
+		return os.str();
+	};
+	auto str = [](const explicit_state& c) {
+		std::ostringstream os;
+		os << c;
+		return os.str();
+	};
+	/// step 3: print the path
+	const bool is_json = flags::OPT_WITNESS == "json";
+	if (is_json)
+		cout << "{\"target\": \"" << final_c << "\", \"initial\": \""
+				<< str(global_R.unpack(*path.front())) << "\", \"steps\": [";
+	else
+		cout << "=> witness: " << path.size() - 1 << " steps\n  "
+				<< global_R.unpack(*path.front()) << "\n";
+	size_k k = 0;
+	for (size_t i = 1; i < path.size(); ++i) {
+		const auto& info = global_R.get_info(*path[i]);
+		const bool is_switch = info.k > k;
+		k = info.k;
+		if (is_json) {
+			cout << (i > 1 ? ", " : "") << "{\"context\": " << k
+					<< ", \"switch\": " << (is_switch ? "true" : "false")
+					<< ", \"thread\": " << info.tid << ", \"action\": ";
+			if (info.action == explicit_state_tid::NO_ACTION)
+				cout << "null";
+			else
+				cout << info.action;
+			cout << ", \"rule\": \"" << rule(info) << "\", \"state\": \""
+					<< str(global_R.unpack(*path[i])) << "\"}";
+		} else {
+			if (is_switch)
+				cout << "  -- context switch to thread " << info.tid << "\n";
+			cout << "  [" << k << "] thread " << info.tid << ": " << rule(info)
+					<< "\n  " << global_R.unpack(*path[i]) << "\n";
+		}
+	}
+	if (is_json)
+		cout << "]}\n";
+}
+
+/// the header of the checkpoints
+static const string CHECKPOINT_MAGIC = "CUBA-CHECKPOINT-1";
+
+/**
+ * Save the explicit exploration, before it explores context k: the
+ * reached states, the states of context k left to explore, the visible
+ * states and generators, and the counters. The checkpoint is written
+ * aside, then renamed, so that a crash leaves the former one intact.
+ * @param k
+ * @param currLevel
+ * @param global_R
+ * @param top_R
+ * @param tops
+ */
+void explicit_cuba::save_checkpoint(const size_k k, const antichain& currLevel,
+		const reached_set& global_R, const visible_state_set& top_R,
+		const visible_state_set& tops) const {
+	const auto filename = flags::OPT_CHECKPOINT + "/checkpoint.bin";
+	FILE* file = std::fopen((filename + ".tmp").c_str(), "wb");
+	if (file == nullptr)
+		throw cuba_runtime_error("Cannot write the checkpoint " + filename);
+	auto write_set = [file](const visible_state_set& V) {
+		const auto& states = V.get_states();
+		binary::write(file, uint64_t(states.size()));
+		for (const auto& v : states) {
+			binary::write(file, v.get_state());
+			binary::write(file, size_n(v.get_local().size()));
+			binary::write(file, v.get_local().data(), v.get_local().size());
+		}
+	};
+	try {
+		binary::write_string(file, CHECKPOINT_MAGIC);
+		binary::write_string(file, problem);
+		binary::write(file, k);
+		binary::write(file, uint(number_of_image_calls));
+		binary::write(file, uint(number_of_skipped_actions));
+		write_set(top_R);
+		write_set(generators);
+		write_set(tops);
+		global_R.save(file);
+		binary::write(file, uint64_t(currLevel.size()));
+		for (const auto& c : currLevel) {
+			binary::write_string(file, global_R.pack(c).get_bytes());
+			binary::write(file, c.get_thread_id());
+			binary::write(file, c.get_preempted());
+			binary::write(file, uint8_t(c.is_summarized()));
+			binary::write(file, c.get_action());
+		}
+	} catch (...) {
+		std::fclose(file);
+		throw;
+	}
+	if (std::fclose(file) != 0
+			|| std::rename((filename + ".tmp").c_str(), filename.c_str()) != 0)
+		throw cuba_runtime_error("Cannot write the checkpoint " + filename);
+	cout << "=> checkpoint saved at context " << k << "\n";
+}
+
+/**
+ * Resume the explicit exploration from the checkpoint saved last. It
+ * returns false if there is no checkpoint yet.
+ * @param k
+ * @param currLevel
+ * @param global_R an empty reached set
+ * @param top_R
+ * @param tops
+ * @return bool
+ */
+bool explicit_cuba::load_checkpoint(size_k& k, antichain& currLevel,
+		reached_set& global_R, visible_state_set& top_R,
+		visible_state_set& tops) {
+	const auto filename = flags::OPT_CHECKPOINT + "/checkpoint.bin";
+	FILE* file = std::fopen(filename.c_str(), "rb");
+	if (file == nullptr) {
+		cout << logger::MSG_WARNING << "No checkpoint " << filename
+				<< ", starting from scratch...\n";
+		return false;
+	}
+	auto read_set = [file](visible_state_set& V) {
+		const auto n = binary::read<uint64_t>(file);
+		for (uint64_t i = 0; i < n; ++i) {
+			const auto q = binary::read<pda_state>(file);
+			vector<pda_alpha> L(binary::read<size_n>(file));
+			binary::read(file, L.data(), L.size());
+			V.insert(visible_state(q, L));
+		}
+	};
+	try {
+		if (binary::read_string(file) != CHECKPOINT_MAGIC)
+			throw cuba_runtime_error("Not a checkpoint: " + filename);
+		if (binary::read_string(file) != problem)
+			throw cuba_runtime_error(
+					"The checkpoint is of another problem or options: "
+							+ filename);
+		k = binary::read<size_k>(file);
+		number_of_image_calls = binary::read<uint>(file);
+		number_of_skipped_actions = binary::read<uint>(file);
+		read_set(top_R);
+		generators = visible_state_set(alpha_ranges);
+		read_set(generators);
+		read_set(tops);
+		global_R.load(file);
+		currLevel.clear();
+		const auto n = binary::read<uint64_t>(file);
+		for (uint64_t i = 0; i < n; ++i) {
+			const auto c = global_R.unpack(
+					packed_state(binary::read_string(file)));
+			currLevel.emplace_back(binary::read<id_thread>(file), k,
+					c.get_state(), c.get_stacks());
+			auto& _c = currLevel.back();
+			_c.set_preempted(binary::read<id_thread>(file));
+			_c.set_summarized(binary::read<uint8_t>(file) != 0);
+			_c.set_action(binary::read<id_action>(file));
+			_c.set_reached(global_R.find(_c));
+		}
+	} catch (...) {
+		std::fclose(file);
+		throw;
+	}
+	std::fclose(file);
+	return true;
+}
+
 uint explicit_cuba::get_number_of_image_calls() const {
 	return number_of_image_calls;
 }
@@ -18,8 +18,10 @@ namespace cuba {
  */
 symbolic_cuba::symbolic_cuba(const string& initl, const string& final,
 		const string& filename) :
-		base_cuba(initl, final, filename) {
+		base_cuba(initl, final, filename), post_cache(POST_CACHE_SIZE), minimized_from(
+				0), minimized_to(0) {
 	cout << logger::MSG_SYM_EXPLORATION;
+	stats::set_engine("symbolic_cuba");
 }
 
 /**
@@ -28,6 +30,8 @@ symbolic_cuba::symbolic_cuba(const string& initl, const string& final,
 symbolic_cuba::~symbolic_cuba() {
 }
 
+const size_t symbolic_cuba::POST_CACHE_SIZE = 4096;
+
 /**
  * The procedure of context-bounded analysis
  * @param k_bound: the upper bounds of contexts
@@ -78,38 +82,120 @@ bool symbolic_cuba::context_bounded_analysis(const size_k k_bound,
 	global_R.emplace_back(deque<symbolic_state> { c_I });
 	/// 1.4 <top_R>: the set of reachable tops of configurations.
 	/// We obtain this by computing the symbolic configurations.
-	vector<set<visible_state>> top_R(thread_visible_state::S);
+	visible_state_set top_R(alpha_ranges);
+	/// 1.5 <forms>: the canonical forms of the symbolic configurations
+	/// reached: a configuration with the same form as a reached one is a
+	/// duplicate of it.
+	unordered_set<string> forms { c_I.get_canonical_form() };
+	/// 1.6 <buckets>: the symbolic configurations kept in global_R, as
+	/// (level, index) pairs, by signature. A new configuration is dropped
+	/// if one in its bucket subsumes it: as they have the same signature,
+	/// no visible state is lost by dropping it.
+	unordered_map<string, vector<pair<size_k, size_t>>> buckets;
+	buckets[get_signature(c_I)].emplace_back(0, 0);
+	/// 1.7 <block_size>: the number of configurations in currLevel
+	/// expanded at a time. Successors are merged in the order of currLevel,
+	/// so the result does not depend on the number of threads
+	const size_t block_size =
+			flags::OPT_NUM_THREADS == 1 ? 1 : 64 * flags::OPT_NUM_THREADS;
 	/// Compute top_R_0
 	converge(global_R, k, top_R);
 	/// Step 2: compute all reachable configurations with up to k_bound
 	/// contexts. If k_bound = 0, the procedure will either loops until R/top_R
 	/// collapses or forever.
 	while (k_bound == 0 || k < k_bound) {
+		/// if reachability and the target visible state is reachable
+		if (flags::OPT_PROB_REACHABILITY && reachable) {
+			break;
+		}
+
 		/// <nextLevel> = S_{k+1} \ S_{k}: the set of symbolic configurations
 		/// reached in the (k+1)st context. It's initialized as empty.
 		deque<symbolic_state> nextLevel;
+		/// determine whether c is to be kept in nextLevel: it's neither a
+		/// duplicate nor subsumed by a configuration kept before
+		auto is_new = [&](const string& form, const symbolic_state& c) {
+			if (!forms.emplace(form).second)
+				return false;
+			auto& bucket = buckets[get_signature(c)];
+			for (const auto& p : bucket) {
+				const auto& _c =
+						p.first < global_R.size() ?
+								global_R[p.first][p.second] :
+								nextLevel[p.second];
+				if (is_subsumed(c, _c))
+					return false;
+			}
+			bucket.emplace_back(k + 1, nextLevel.size());
+			return true;
+		};
+		/// the number of symbolic configurations composed and Post*
+		/// computed in this context, and the lookups of post_cache before it
+		ulong generated = 0, image_calls = 0;
+		const auto hits = post_cache.get_hits();
+		const auto misses = post_cache.get_misses();
+		const ulong from = minimized_from, to = minimized_to;
 		/// step 2.1 compute nextLevel, or S_{k+1}: iterate over all elements
 		/// in the currLevel. This is a BFS-like procedure.
 		while (!currLevel.empty()) {
-			/// 2.1.1 remove a aggregate configuration from currLevel.
-			const auto c = currLevel.front();
-			currLevel.pop_front();
-
-			/// 2.1.2 extract the aggregate configuration from the pair.
-			const auto& automata = c.get_automata();
-			for (uint i = 0; i < automata.size(); ++i) {
-				if (automata[i].empty())
-					continue;
-				const auto& _A = post_kleene(automata[i], CPDA[i]);
-				for (const auto& _q : project_Q(_A))
-					nextLevel.push_back(compose(_q, _A, automata, i));
+			stats::timer t(stats::phase::EXPANSION, k);
+			/// 2.1.1 remove a block of aggregate configurations from
+			/// currLevel, and list its jobs: a job computes Post* of a
+			/// thread of a configuration, and composes its successors.
+			const auto n = std::min(currLevel.size(), block_size);
+			const vector<symbolic_state> block(currLevel.begin(),
+					currLevel.begin() + n);
+			currLevel.erase(currLevel.begin(), currLevel.begin() + n);
+			vector<pair<size_t, size_n>> jobs;
+			for (size_t j = 0; j < n; ++j) {
+				const auto& automata = block[j].get_automata();
+				for (size_n i = 0; i < automata.size(); ++i)
+					if (!automata[i].empty())
+						jobs.emplace_back(j, i);
 			}
-		}
 
-		/// if reachability and the target visible state is reachable
-		if (flags::OPT_PROB_REACHABILITY && reachable) {
-			break;
+			/// 2.1.2 run the jobs, in parallel if required. A job keeps the
+			/// successors with their canonical forms, but the ones reached
+			/// before the block: forms is only read while the jobs run.
+			vector<vector<pair<string, symbolic_state>>> images(jobs.size());
+			vector<ulong> composed(jobs.size());
+			parallel::for_each(jobs.size(), flags::OPT_NUM_THREADS,
+					[&](const size_t j) {
+						const auto& automata = block[jobs[j].first].get_automata();
+						const auto i = jobs[j].second;
+						const auto& _A = post_kleene(automata[i], i);
+						for (const auto& _q : project_Q(_A)) {
+							const auto& _c = compose(_q, _A, automata, i);
+							const auto& form = _c.get_canonical_form();
+							++composed[j];
+							if (forms.count(form) == 0)
+								images[j].emplace_back(form, _c);
+						}
+					});
+			image_calls += jobs.size();
+
+			/// 2.1.3 process the successors one by one, in the same order
+			/// as a sequential exploration does
+			for (size_t j = 0; j < jobs.size(); ++j) {
+				generated += composed[j];
+				for (const auto& image : images[j])
+					if (is_new(image.first, image.second))
+						nextLevel.push_back(image.second);
+			}
+		}
+		stats::count(k, generated, nextLevel.size(), image_calls);
+		stats::count_cache(k, post_cache.get_hits() - hits,
+				post_cache.get_misses() - misses);
+		stats::count_minimized(k, minimized_from - from, minimized_to - to);
+		stats::set_frontier(k, nextLevel.size());
+		/// if nothing new is reached in the (k+1)st context, then the set of
+		/// reachable configurations, and so top_R, is exact
+		if (nextLevel.empty()) {
+			cout << logger::MSG_TR_COLLAPSE_AT_K << k << "\n";
+			return true;
 		}
+		if (k == std::numeric_limits<size_k>::max())
+			throw cuba_runtime_error("The number of contexts overflows");
 
 		/// step 2.2 if all elements in currLevel has been processed, then move
 		/// onto the (k + 1)st context.
@@ -143,18 +229,19 @@ store_automaton symbolic_cuba::create_init_automaton(
 	/// step 3: set up the set of transitions
 	fsa_delta delta;
 
+	/// the intermediate states are numbered from S on
 	auto q = q_I;
 	if (!w.empty()) {
-		for (const auto a : w.get_worklist()) {
-			auto _q = store_automaton::create_interm_state();
+		for (const auto a : w) {
+			const fsa_state _q = thread_visible_state::S + states.size();
 			states.emplace(_q);
-			delta[q].emplace(q, _q, a);
+			delta.emplace(q, _q, a);
 			q = _q;
 		}
 	} else { /// if stack w is empty, then add a epsilon transition
-		auto _q = store_automaton::create_interm_state();
+		const fsa_state _q = thread_visible_state::S;
 		states.emplace(_q);
-		delta[q].emplace(q, _q, alphabet::EPSILON);
+		delta.emplace(q, _q, alphabet::EPSILON);
 	}
 	/// step 4: set up the accept state
 	const auto q_F = *states.rbegin();
@@ -162,94 +249,280 @@ store_automaton symbolic_cuba::create_init_automaton(
 }
 
 /**
- * Post*(A): compute all reachable states from states represented by A
+ * Post*(A) for thread tid: it's looked up in the cache of Post* by the
+ * canonical form of A first, and computed and minimized if it isn't
+ * there. The Post* found may thus name its states differently from A.
  * @param A a store automaton
+ * @param tid
+ * @return store_automaton
+ */
+store_automaton symbolic_cuba::post_kleene(const store_automaton& A,
+		const size_n tid) {
+	const auto& key = std::to_string(tid) + "|" + A.get_canonical_form();
+	{
+		std::lock_guard<std::mutex> guard(post_lock);
+		const auto cached = post_cache.find(key);
+		if (cached != nullptr)
+			return *cached;
+	}
+	/// Post* is computed out of the lock: if two threads compute the same
+	/// Post*, the one inserted last is kept
+	const auto& _A = minimize(post_kleene(A, CPDA[tid]));
+	std::lock_guard<std::mutex> guard(post_lock);
+	post_cache.insert(key, _A);
+	return _A;
+}
+
+/**
+ * Post*(A): compute all reachable states from states represented by A.
+ * This is the saturation procedure of Schwoon's thesis: a transition is
+ * put into the worklist the first time it is seen, the rules applying to
+ * it are looked up in the transition table of P, and the epsilon
+ * transitions into the states created for push rules are kept, so that
+ * a transition added from such a state is closed under them at once.
+ * The states created are numbered after the states of A, so that Post*(A)
+ * is numbered densely if A is.
+ * @param A a store automaton
+ * @param P a pushdown automaton
  * @return store_automaton
  */
 store_automaton symbolic_cuba::post_kleene(const store_automaton& A,
 		const pushdown_automaton& P) {
 	auto states = A.get_states();
-	fsa_delta deltas; /// the transitions of Post*(A)
-
-	const auto& actions = P.get_actions();
-	unordered_map<uint, fsa_state> load_interm_states;
-	for (uint rid = 0; rid < actions.size(); ++rid) {
-		if (actions[rid].get_oper_type() == type_stack_operation::PUSH) {
-			const auto s = store_automaton::create_interm_state();
-			load_interm_states.emplace(rid, s), states.emplace(s);
-		}
-	}
+	/// <next>: the state to be created next
+	fsa_state next = std::max(A.get_accept(),
+			states.empty() ? A.get_accept() : *states.rbegin()) + 1;
+	/// <deltas>: the transitions of Post*(A) seen so far, whether they
+	/// have been processed or are still in the worklist
+	fsa_delta deltas;
+	/// <worklist>: the transitions from control states to be processed
+	vector<fsa_transition> worklist;
+	/// <epsilon_in>: the sources of the epsilon transitions seen so far,
+	/// indexed by their destinations
+	unordered_map<fsa_state, vector<fsa_state>> epsilon_in;
+	/// <mid_states>: the state q_{p', a1} created for the push rules
+	/// (p, a) -> (p', a1 a2), indexed by (p', a1)
+	unordered_map<uint64_t, fsa_state> mid_states;
 
-	deque<fsa_transition> worklist;
-	fsa_delta epsilon_R; /// used to handle epsilon transitions
+	/// add transition (p, a, q) if it has not been seen
+	auto add = [&](const fsa_state p, const fsa_state q, const fsa_alpha a) {
+		if (!deltas.emplace(p, q, a))
+			return;
+		if (a == alphabet::EPSILON)
+			epsilon_in[q].emplace_back(p);
+		if (p < thread_visible_state::S)
+			worklist.emplace_back(p, q, a);
+	};
 
 	/// initialize the worklist
-	for (const auto& trans : A.get_transitions()) {
-		for (const auto& t : trans.second) {
-			worklist.emplace_back(t);
-			if (t.get_label() == alphabet::EPSILON)
-				epsilon_R[t.get_src()].emplace(t);
-		}
+	for (const auto& transs : A.get_transitions()) {
+		for (const auto& t : transs)
+			add(t.get_src(), t.get_dst(), t.get_label());
 	}
 
 	while (!worklist.empty()) {
-		const auto t = worklist.front(); /// FSA transition (p, a, q)
-		worklist.pop_front();
+		const auto t = worklist.back(); /// FSA transition (p, a, q)
+		worklist.pop_back();
 
 		/// FSA transition (p, a, q)
-		const auto& p = t.get_src();
-		const auto& a = t.get_label();
-		const auto& q = t.get_dst();
-
-		const auto& ret = deltas[p].insert(t);
-		if (!ret.second || p >= thread_visible_state::S)
-			continue;
+		const auto p = t.get_src();
+		const auto a = t.get_label();
+		const auto q = t.get_dst();
 
 		if (a != alphabet::EPSILON) { /// if label != epsilon
-			auto ifind = P.get_program().find(thread_visible_state(p, a));
-			if (ifind != P.get_program().end()) {
-				for (const auto rid : ifind->second) {
-					const auto& r = actions[rid]; /// PDA transition
-					const auto& _p = r.get_dst().get_state(); /// state
-					auto _W = r.get_dst().get_stack(); /// stack: maintain a copy
-
-					switch (r.get_oper_type()) {
-					case type_stack_operation::POP: { /// pop
-						worklist.emplace_back(_p, q, alphabet::EPSILON);
-						epsilon_R[_p].emplace(_p, q, alphabet::EPSILON); /// epsilon transitions
-					}
-						break;
-					case type_stack_operation::OVERWRITE: { /// overwrite
-						worklist.emplace_back(_p, q, _W.top());
+			for (const auto& m : P.get_moves(p, a)) {
+				switch (m.op) {
+				case type_stack_operation::POP: { /// pop
+					add(m.dst, q, alphabet::EPSILON);
+				}
+					break;
+				case type_stack_operation::OVERWRITE: { /// overwrite
+					add(m.dst, q, m.top);
+				}
+					break;
+				default: { /// push
+					const auto key = (uint64_t(m.dst) << 32) | m.top;
+					auto ifind = mid_states.find(key);
+					if (ifind == mid_states.end()) {
+						const auto s = next++;
+						states.emplace(s);
+						ifind = mid_states.emplace(key, s).first;
 					}
+					const auto q_mid = ifind->second;
+					add(m.dst, q_mid, m.top);
+					/// (q_mid, a2, q) is closed under the epsilon
+					/// transitions into q_mid seen so far; those seen
+					/// later are closed when they are processed
+					if (!deltas.emplace(q_mid, q, m.below))
 						break;
-					default: { /// push
-						const auto& q_in = load_interm_states[rid];
-						const auto& a1 = _W.top();
-						_W.pop();
-						const auto& a2 = _W.top();
-						_W.pop();
-
-						worklist.emplace_back(_p, q_in, a1);
-						deltas[q_in].emplace(q_in, q, a2);
-
-						for (const auto& _t : epsilon_R[q_in]) {
-							if (_t.get_label() == alphabet::EPSILON)
-								worklist.emplace_back(_t.get_src(), q_in, a2);
-						}
-					}
+					auto iepsilon = epsilon_in.find(q_mid);
+					if (iepsilon == epsilon_in.end())
 						break;
-					}
+					for (const auto _p : iepsilon->second)
+						add(_p, q, m.below);
+				}
+					break;
 				}
 			}
 		} else { /// if label == epsilon
-			for (const auto& _t : deltas[q])  /// _t = (q, a', q')
-				worklist.emplace_back(p, _t.get_dst(), _t.get_label()); /// (p, a', q')
+			const auto transs = deltas.get(q);
+			for (const auto& _t : transs)  /// _t = (q, a', q')
+				add(p, _t.get_dst(), _t.get_label()); /// (p, a', q')
 		}
 	}
 
-	return store_automaton(states, A.get_alphas(), deltas, P.get_states(),
-			A.get_accept());
+	/// the alphabet and the accept state are shared with A
+	auto _A = A;
+	_A.set_states(states);
+	_A.set_transitions(deltas);
+	_A.set_initials(P.get_states());
+	return _A;
+}
+
+/**
+ * Minimize A: remove the states which are not reachable from a start state
+ * or which cannot reach the accept state, and then merge the states with
+ * the same right languages, and the states with the same left languages.
+ * These are the forward and the backward bisimilar states, computed by
+ * partition refinement: on a deterministic automaton, the first pass
+ * merges exactly the states Hopcroft's algorithm merges. Neither the
+ * control states nor the accept state are merged. The states counted
+ * before and after are added to minimized_from and minimized_to.
+ * @param A
+ * @return store_automaton
+ */
+store_automaton symbolic_cuba::minimize(const store_automaton& A) {
+	const auto& delta = A.get_transitions();
+	const auto accept = A.get_accept();
+	minimized_from += A.get_states().size();
+
+	/// step 1: trim A. Collect the states reachable from the start states,
+	/// and then the transitions from which the accept state is reachable
+	unordered_set<fsa_state> reached;
+	vector<fsa_state> worklist;
+	for (const auto q : A.get_start())
+		if (reached.emplace(q).second)
+			worklist.emplace_back(q);
+	while (!worklist.empty()) {
+		const auto p = worklist.back();
+		worklist.pop_back();
+		for (const auto& r : delta.get(p))
+			if (reached.emplace(r.get_dst()).second)
+				worklist.emplace_back(r.get_dst());
+	}
+	unordered_map<fsa_state, vector<fsa_transition>> incoming;
+	for (const auto q : reached)
+		for (const auto& r : delta.get(q))
+			incoming[r.get_dst()].emplace_back(r);
+	vector<fsa_transition> transs;
+	unordered_set<fsa_state> useful;
+	if (reached.count(accept) > 0) {
+		useful.emplace(accept);
+		worklist.emplace_back(accept);
+	}
+	while (!worklist.empty()) {
+		const auto q = worklist.back();
+		worklist.pop_back();
+		for (const auto& r : incoming[q]) {
+			transs.emplace_back(r);
+			if (useful.emplace(r.get_src()).second)
+				worklist.emplace_back(r.get_src());
+		}
+	}
+	bool is_changed = transs.size() < delta.size();
+
+	/// step 2: merge the bisimilar states of transs, forward or backward.
+	/// Each state starts in the block of its own if it's a control state
+	/// or the accept state, in a common block otherwise; the blocks are
+	/// split by the labels and the blocks of the successors (predecessors,
+	/// if backward) of their states, until none is split.
+	auto merge = [&](const bool is_forward) {
+		unordered_map<fsa_state, vector<pair<fsa_alpha, fsa_state>>> adj;
+		unordered_map<fsa_state, uint> block;
+		for (const auto& r : transs) {
+			const auto p = is_forward ? r.get_src() : r.get_dst();
+			const auto q = is_forward ? r.get_dst() : r.get_src();
+			adj[p].emplace_back(r.get_label(), q);
+			for (const auto s : { p, q })
+				block.emplace(s,
+						s < thread_visible_state::S ? s :
+						s == accept ? thread_visible_state::S :
+								thread_visible_state::S + 1);
+		}
+		size_t blocks = 0;
+		while (true) {
+			map<pair<uint, vector<pair<fsa_alpha, uint>>>, uint> splits;
+			unordered_map<fsa_state, uint> _block;
+			for (const auto& sb : block) {
+				vector<pair<fsa_alpha, uint>> signature;
+				for (const auto& aq : adj[sb.first])
+					signature.emplace_back(aq.first, block[aq.second]);
+				std::sort(signature.begin(), signature.end());
+				signature.erase(std::unique(signature.begin(), signature.end()),
+						signature.end());
+				_block.emplace(sb.first,
+						splits.emplace(std::make_pair(sb.second, signature),
+								splits.size()).first->second);
+			}
+			block.swap(_block);
+			if (splits.size() == blocks)
+				break;
+			blocks = splits.size();
+		}
+		if (block.size() == blocks)
+			return;
+		/// the representative of a block: the control state or the accept
+		/// state it holds, its least state otherwise
+		unordered_map<uint, fsa_state> reps;
+		for (const auto& sb : block) {
+			auto ret = reps.emplace(sb.second, sb.first);
+			if (!ret.second && ret.first->second != accept
+					&& (sb.first == accept || sb.first < ret.first->second))
+				ret.first->second = sb.first;
+		}
+		for (auto& r : transs)
+			r = fsa_transition(reps[block[r.get_src()]],
+					reps[block[r.get_dst()]], r.get_label());
+		std::sort(transs.begin(), transs.end());
+		transs.erase(std::unique(transs.begin(), transs.end()), transs.end());
+		is_changed = true;
+	};
+	merge(true);
+	merge(false);
+
+	if (!is_changed) {
+		minimized_to += A.get_states().size();
+		return A;
+	}
+	/// step 3: build the minimized automaton, sharing the alphabet with A.
+	/// Its intermediate states are renumbered densely, from S on, in the
+	/// order of their ids; the accept state is numbered last if it's not
+	/// reachable.
+	fsa_state_set states;
+	for (const auto& r : transs)
+		for (const auto s : { r.get_src(), r.get_dst() })
+			if (s >= thread_visible_state::S)
+				states.emplace(s);
+	unordered_map<fsa_state, fsa_state> ids;
+	for (const auto s : states)
+		ids.emplace(s, thread_visible_state::S + ids.size());
+	auto id = [&ids](const fsa_state s) {
+		return s < thread_visible_state::S ? s : ids.at(s);
+	};
+	fsa_state_set _states;
+	for (const auto s : states)
+		_states.emplace(ids[s]);
+	fsa_delta deltas;
+	for (const auto& r : transs)
+		deltas.emplace(id(r.get_src()), id(r.get_dst()), r.get_label());
+	minimized_to += states.size();
+	auto _A = A;
+	_A.set_states(_states);
+	_A.set_transitions(deltas);
+	_A.set_accept(
+			states.count(accept) > 0 ?
+					ids[accept] : thread_visible_state::S + states.size());
+	return _A;
 }
 
 /**
@@ -264,7 +537,7 @@ bool symbolic_cuba::is_recongnizable(const store_automaton& A,
 	queue<pair<fsa_state, uint>> worklist;
 	worklist.emplace(c.get_state(), 0);
 
-	const auto& w = c.get_stack();
+	const vector<pda_alpha> w(c.get_stack().begin(), c.get_stack().end());
 	while (!worklist.empty()) {
 		const auto u = worklist.front();
 		worklist.pop();
@@ -272,12 +545,8 @@ bool symbolic_cuba::is_recongnizable(const store_automaton& A,
 		const auto& state = u.first;
 		const auto& depth = u.second;
 
-		auto ifind = A.get_transitions().find(state);
-		if (ifind == A.get_transitions().end())
-			continue;
-
-		for (const auto& r : ifind->second)
-			if (r.get_label() == w.get_worklist()[depth]) {
+		for (const auto& r : A.get_transitions().get(state))
+			if (r.get_label() == w[depth]) {
 				if (depth + 1 == w.size()) {
 					if (r.get_dst() == A.get_accept())
 						return true;
@@ -290,20 +559,150 @@ bool symbolic_cuba::is_recongnizable(const store_automaton& A,
 }
 
 /**
- * Determine the equivalence of two finite automatons. This implementation
- * is based on the Hopcroft-Karp algorithm.
- *
- * TODO: need to implement it, but please keep in mind that the algorithm
- * is very inefficient.
+ * Determine whether L(A1) is included in L(A2), by the antichain algorithm:
+ * it explores the pairs (p, Y), where p is a state of A1 and Y is the
+ * macrostate of A2 reached on the same word. L(A1) is not included in L(A2)
+ * iff a pair where p is accepting but Y is not is reachable. A pair (p, Y)
+ * is not explored if a pair (p, Y') with Y' a subset of Y has been, as any
+ * word accepted from Y' is accepted from Y.
  * @param A1
  * @param A2
  * @return bool
  */
-bool symbolic_cuba::is_equivalent(const store_automaton& A1,
+bool symbolic_cuba::is_included(const store_automaton& A1,
 		const store_automaton& A2) {
+	/// the minimal macrostates explored with each state of A1
+	unordered_map<fsa_state, vector<vector<fsa_state>>> antichain;
+	deque<pair<fsa_state, vector<fsa_state>>> worklist;
+	/// add (p, Y) to the antichain, return false if it's a counterexample
+	auto add = [&](const fsa_state p, const vector<fsa_state>& Y) {
+		if (p == A1.get_accept()
+				&& !std::binary_search(Y.begin(), Y.end(), A2.get_accept()))
+			return false;
+		auto& Ys = antichain[p];
+		for (const auto& _Y : Ys)
+			if (std::includes(Y.begin(), Y.end(), _Y.begin(), _Y.end()))
+				return true;
+		Ys.erase(std::remove_if(Ys.begin(), Ys.end(),
+				[&Y](const vector<fsa_state>& _Y) {
+					return std::includes(_Y.begin(), _Y.end(),
+							Y.begin(), Y.end());
+				}), Ys.end());
+		Ys.emplace_back(Y);
+		worklist.emplace_back(p, Y);
+		return true;
+	};
+
+	const auto& start1 = A1.get_start(), start2 = A2.get_start();
+	const auto& Y0 = epsilon_closure(A2,
+			vector<fsa_state>(start2.begin(), start2.end()));
+	for (const auto p : epsilon_closure(A1,
+			vector<fsa_state>(start1.begin(), start1.end())))
+		if (!add(p, Y0))
+			return false;
+	while (!worklist.empty()) {
+		const auto pY = worklist.front();
+		worklist.pop_front();
+		for (const auto& r : A1.get_transitions().get(pY.first)) {
+			if (r.get_label() == alphabet::EPSILON)
+				continue;
+			const auto& _Y = successors(A2, pY.second, r.get_label());
+			for (const auto _p : epsilon_closure(A1, { r.get_dst() }))
+				if (!add(_p, _Y))
+					return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Determine whether the symbolic state c1 is subsumed by c2, i.e., every
+ * configuration c1 denotes is denoted by c2: they have the same shared
+ * state, and the language of each automaton of c1 is included in the one
+ * of c2.
+ * @param c1
+ * @param c2
+ * @return bool
+ */
+bool symbolic_cuba::is_subsumed(const symbolic_state& c1,
+		const symbolic_state& c2) {
+	if (c1.get_state() != c2.get_state())
+		return false;
+	const auto& W1 = c1.get_automata();
+	const auto& W2 = c2.get_automata();
+	for (uint i = 0; i < W1.size(); ++i)
+		if (!is_included(W1[i], W2[i]))
+			return false;
 	return true;
 }
 
+/**
+ * Return the signature of a symbolic state: its shared state and the top
+ * symbols of its automata. A symbolic state only subsumes the ones with
+ * the same signature without reaching more visible states than them.
+ * @param c
+ * @return string
+ */
+string symbolic_cuba::get_signature(const symbolic_state& c) {
+	const auto q = c.get_state();
+	string signature(reinterpret_cast<const char*>(&q), sizeof(q));
+	for (const auto& A : c.get_automata()) {
+		for (const auto s : top_mapping(A, q))
+			signature.append(reinterpret_cast<const char*>(&s), sizeof(s));
+		signature.push_back('|');
+	}
+	return signature;
+}
+
+/**
+ * Return the epsilon closure of a set of states X of A
+ * @param A
+ * @param X
+ * @return the closure, sorted
+ */
+vector<fsa_state> symbolic_cuba::epsilon_closure(const store_automaton& A,
+		vector<fsa_state> X) {
+	std::sort(X.begin(), X.end());
+	X.erase(std::unique(X.begin(), X.end()), X.end());
+	auto worklist = X;
+	while (!worklist.empty()) {
+		const auto p = worklist.back();
+		worklist.pop_back();
+		/// the epsilon transitions follow the others, as EPSILON is the
+		/// greatest label
+		const auto& transs = A.get_transitions().get(p);
+		for (auto r = transs.rbegin(); r != transs.rend(); ++r) {
+			if (r->get_label() != alphabet::EPSILON)
+				break;
+			const auto _p = r->get_dst();
+			auto ifind = std::lower_bound(X.begin(), X.end(), _p);
+			if (ifind == X.end() || *ifind != _p) {
+				X.insert(ifind, _p);
+				worklist.emplace_back(_p);
+			}
+		}
+	}
+	return X;
+}
+
+/**
+ * Return the states of A reached from X by reading a, closed under
+ * epsilon transitions
+ * @param A
+ * @param X
+ * @param a
+ * @return the successors, sorted
+ */
+vector<fsa_state> symbolic_cuba::successors(const store_automaton& A,
+		const vector<fsa_state>& X, const fsa_alpha a) {
+	vector<fsa_state> _X;
+	for (const auto p : X)
+		for (const auto& r : A.get_transitions().get(p))
+			if (r.get_label() == a)
+				_X.emplace_back(r.get_dst());
+	return epsilon_closure(A, _X);
+}
+
 /**
  * This procedure projects all states g such that {g| exist w. <g, w> in L(A)}.
  * It returns a set of states.
@@ -404,17 +803,19 @@ store_automaton symbolic_cuba::rename(const store_automaton& A,
 	if (A.get_start().size() == 0)
 		throw cuba_runtime_error("rename: no initial state");
 	auto old = *A.get_start().begin();
-	auto ifind = A.get_transitions().find(old);
-	if (ifind == A.get_transitions().end())
-		return store_automaton(A.get_states(), A.get_alphas(),
-				A.get_transitions(), { q_I }, A.get_accept());
+	/// the states and the alphabet are shared with A
+	auto _A = A;
+	_A.set_initials( { q_I });
+	const auto& transs = A.get_transitions().get(old);
+	if (transs.empty())
+		return _A;
 	auto deltas = A.get_transitions();
 	deltas.erase(old);
-	for (const auto& r : ifind->second) {
-		deltas[q_I].emplace(q_I, r.get_dst(), r.get_label());
+	for (const auto& r : transs) {
+		deltas.emplace(q_I, r.get_dst(), r.get_label());
 	}
-	return store_automaton(A.get_states(), A.get_alphas(), deltas, { q_I },
-			A.get_accept());
+	_A.set_transitions(deltas);
+	return _A;
 }
 
 /**
@@ -449,32 +850,40 @@ store_automaton symbolic_cuba::anonymize_by_split(const store_automaton& A,
 	fsa_state_set states;
 	fsa_delta deltas;
 
+	/// the new ids of the intermediate states: they are renumbered
+	/// densely, from S on, in the order they are reached
+	unordered_map<fsa_state, fsa_state> ids;
 	queue<fsa_state> worklist;
+	auto id = [&](const fsa_state q) {
+		if (q < thread_visible_state::S)
+			return q;
+		auto ret = ids.emplace(q, thread_visible_state::S + ids.size());
+		if (ret.second) {
+			states.emplace(ret.first->second);
+			worklist.emplace(q);
+		}
+		return ret.first->second;
+	};
 	worklist.emplace(q_I);
 	while (!worklist.empty()) {
 		const auto q = worklist.front();
 		worklist.pop();
 
-		/// insert q into the states of anonymized automaton
-		auto ret = states.emplace(q);
-		if (!ret.second)
-			continue; /// skip q if q has been processed
-
-		/// find q's successors, if applicable
-		auto ifind = A.get_transitions().find(q);
-		if (ifind == A.get_transitions().end())
-			continue; /// skip q if q has no successor
-
-		/// processed q and its successors
-		for (const auto& r : ifind->second) {
-			deltas[q].emplace(r);
-			worklist.emplace(r.get_dst());
-		}
+		/// processed q and its successors, if applicable
+		const auto _q = id(q);
+		for (const auto& r : A.get_transitions().get(q))
+			deltas.emplace(_q, id(r.get_dst()), r.get_label());
 	}
-	states.erase(q_I); /// remove the initial state q_I from states,
-					   /// as states only have intermediate states
-	return store_automaton(states, A.get_alphas(), deltas, { q_I },
-			A.get_accept());
+	/// the alphabet is shared with A
+	auto _A = A;
+	_A.set_states(states);
+	_A.set_transitions(deltas);
+	_A.set_initials( { q_I });
+	auto ifind = ids.find(A.get_accept());
+	_A.set_accept(
+			ifind != ids.end() ?
+					ifind->second : thread_visible_state::S + ids.size());
+	return _A;
 }
 
 /**
@@ -511,11 +920,16 @@ store_automaton symbolic_cuba::anonymize_by_rename(const store_automaton& A,
  * @return bool
  */
 bool symbolic_cuba::converge(const vector<deque<symbolic_state>>& R,
-		const size_k k, vector<set<visible_state>>& top_R) {
+		const size_k k, visible_state_set& top_R) {
 	cout << logger::MSG_SEPARATOR;
 	cout << "context " << k << "\n";
-	const auto cnt_new_top_cfg = top_mapping(R[k], top_R);
+	uint cnt_new_top_cfg = 0;
+	{
+		stats::timer t(stats::phase::TOP_MAPPING, k);
+		cnt_new_top_cfg = top_mapping(R[k], top_R);
+	}
 	if (cnt_new_top_cfg == 0) {
+		stats::timer t(stats::phase::CONVERGENCE, k);
 		if (is_convergent())
 			return true;
 		cout << logger::MSG_TR_PLATEAU_AT_K << k << "\n";
@@ -529,11 +943,7 @@ bool symbolic_cuba::converge(const vector<deque<symbolic_state>>& R,
  * @return bool
  */
 bool symbolic_cuba::is_convergent() {
-	for (const auto& s : generators) {
-		if (!s.empty())
-			return false;
-	}
-	return true;
+	return generators.empty();
 }
 
 /**
@@ -543,102 +953,86 @@ bool symbolic_cuba::is_convergent() {
  * @return
  */
 uint symbolic_cuba::top_mapping(const deque<symbolic_state>& R,
-		vector<set<visible_state>>& topped_R) {
+		visible_state_set& topped_R) {
 	uint cnt_new_top_cfg = 0;
-	for (const auto& c : R) {
-		for (const auto& top_c : top_mapping(c)) {
-			if (flags::OPT_PROB_REACHABILITY && top_c == final_c) {
-				reachable = true;
-			}
-			auto ret = topped_R[top_c.get_state()].emplace(top_c);
-			if (ret.second) {
-				cout << string(2, ' ') << top_c << "\n";
-				++cnt_new_top_cfg;
-				/// updating approx_X
-				auto ifind = generators[top_c.get_state()].find(top_c);
-				if (ifind != generators[top_c.get_state()].end()) {
-					generators[top_c.get_state()].erase(ifind);
-				}
-			}
+	/// add top_c to topped_R; stop if reachability and top_c is the target
+	auto add = [&](const visible_state& top_c) {
+		if (flags::OPT_PROB_REACHABILITY && top_c == final_c) {
+			reachable = true;
+		}
+		if (topped_R.insert(top_c)) {
+			cout << string(2, ' ') << top_c << "\n";
+			++cnt_new_top_cfg;
+			/// updating approx_X
+			generators.erase(top_c);
 		}
+		return !(flags::OPT_PROB_REACHABILITY && reachable);
+	};
+	for (const auto& c : R) {
+		if (!top_mapping(c, add))
+			break;
 	}
 	return cnt_new_top_cfg;
 }
 
 /**
- * Extract all configuration tops of symbolic configuration tau
+ * Enumerate the configuration tops of symbolic configuration tau, one at
+ * a time: its shared state with each combination of the top symbols of
+ * its threads. The combinations are enumerated as an odometer, whose ith
+ * digit ranges over the top symbols of thread i, and the first digit
+ * turns fastest; only the current combination is stored.
  * @param tau
- * @return a set of configuration tops
+ * @param f the function applied to each configuration top. The
+ *        enumeration stops if it returns false.
+ * @return false if the enumeration is stopped by f
  */
-vector<visible_state> symbolic_cuba::top_mapping(const symbolic_state& tau) {
+bool symbolic_cuba::top_mapping(const symbolic_state& tau,
+		const std::function<bool(const visible_state&)>& f) {
 	const auto q = tau.get_state();
-	vector<set<pda_alpha>> toppings(tau.get_automata().size());
-
-	for (uint i = 0; i < tau.get_automata().size(); ++i) {
-		toppings[i] = top_mapping(tau.get_automata()[i], q);
-		//for (const auto& s : toppings[i])
-		//	cout << i << "===================" << s << endl;
+	const auto& automata = tau.get_automata();
+	vector<vector<pda_alpha>> tops(automata.size());
+	for (uint i = 0; i < automata.size(); ++i) {
+		const auto& ts = top_mapping(automata[i], q);
+		if (ts.empty())
+			return true;
+		tops[i].assign(ts.begin(), ts.end());
 	}
 
-	const auto& worklist = cross_product(toppings);
-
-	vector<visible_state> tops;
-	tops.reserve(worklist.size());
-	for (const auto& W : worklist) {
-		tops.emplace_back(q, W);
+	/// the digits of the odometer, and the top symbols they denote
+	vector<size_t> digits(tops.size(), 0);
+	vector<pda_alpha> L(tops.size());
+	for (uint i = 0; i < tops.size(); ++i)
+		L[i] = tops[i][0];
+	while (true) {
+		if (!f(visible_state(q, L)))
+			return false;
+		/// turn the odometer: the digits wrapping around reset to 0 and
+		/// carry over to the next one
+		uint i = 0;
+		for (; i < digits.size(); ++i) {
+			if (++digits[i] < tops[i].size()) {
+				L[i] = tops[i][digits[i]];
+				break;
+			}
+			digits[i] = 0;
+			L[i] = tops[i][0];
+		}
+		if (i == digits.size())
+			return true;
 	}
-	return tops;
 }
 
 /**
- * Extract all top symbols of a store automaton
+ * Extract all top symbols of a store automaton. They are cached in A, so
+ * that the signature of a symbolic configuration and its configuration
+ * tops share them.
  * @param A
  * @param q
  * @return a set of top symbols
  */
-set<pda_alpha> symbolic_cuba::top_mapping(const store_automaton& A,
+const set<pda_alpha>& symbolic_cuba::top_mapping(const store_automaton& A,
 		const pda_state q) {
-	set<pda_alpha> tops; /// the set of top symbols
-	queue<pda_state> worklist; ///
-	worklist.emplace(q);
-	while (!worklist.empty()) {
-		const auto p = worklist.front();
-		worklist.pop();
-
-		auto ifind = A.get_transitions().find(p);
-		if (ifind == A.get_transitions().end()) {
-			continue;
-		}
-		/// iterate all out-going edges
-		for (const auto& r : ifind->second) {
-			if (r.get_label() == alphabet::EPSILON) /// epsilon label
-				worklist.emplace(r.get_dst());
-			tops.emplace(r.get_label());
-		}
-	}
-	return tops;
-}
-
-/**
- * Compute the cross product of all tops
- * @param tops
- * @return the cross product of tops
- */
-vector<vector<pda_alpha>> symbolic_cuba::cross_product(
-		const vector<set<pda_alpha>>& tops) {
-	vector<vector<pda_alpha>> worklist;
-	worklist.emplace_back(vector<pda_alpha>());
-	for (const auto& ts : tops) {
-		vector<vector<pda_alpha>> temp;
-		for (const auto s : ts) {
-			for (auto W : worklist) {
-				W.emplace_back(s);
-				temp.emplace_back(W);
-			}
-		}
-		worklist.swap(temp);
-	}
-	return worklist;
+	return A.get_tops(q);
 }
 
 } /* namespace cuba */
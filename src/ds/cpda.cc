@@ -110,6 +110,179 @@ visible_state::~visible_state() {
 
 }
 
+/////////////////////////////////////////////////////////////////////////
+/// The set of visible states
+///
+/////////////////////////////////////////////////////////////////////////
+
+const ulong visible_state_set::MAX_DENSE_CODES = 1UL << 22;
+
+/**
+ * Constructor: choose the storage from the number of possible codes
+ * @param ranges the range of stack symbols of each thread
+ */
+visible_state_set::visible_state_set(const vector<alpha_range>& ranges) :
+		lo(ranges.size()), radix(ranges.size()), storage(mode::TREE), bits(), codes(), states(), n(
+				0) {
+	/// the number of codes; 0 if it does not fit in 64 bits
+	ulong size = thread_visible_state::S;
+	for (size_t i = 0; i < ranges.size(); ++i) {
+		lo[i] = ranges[i].first;
+		/// one more value for an empty stack
+		radix[i] = ulong(ranges[i].second - ranges[i].first) + 2;
+		if (size > std::numeric_limits<ulong>::max() / radix[i])
+			size = 0;
+		else
+			size *= radix[i];
+	}
+	if (size == 0) {
+		storage = mode::TREE;
+	} else if (size <= MAX_DENSE_CODES) {
+		storage = mode::DENSE;
+		bits.resize(size, false);
+	} else {
+		storage = mode::HASHED;
+	}
+}
+
+/**
+ * destructor
+ */
+visible_state_set::~visible_state_set() {
+
+}
+
+/**
+ * Insert v into the set
+ * @param v
+ * @return bool true if v is new, false otherwise
+ */
+bool visible_state_set::insert(const visible_state& v) {
+	bool is_new = false;
+	switch (storage) {
+	case mode::DENSE: {
+		const auto code = encode(v);
+		is_new = !bits[code];
+		bits[code] = true;
+	}
+		break;
+	case mode::HASHED:
+		is_new = codes.emplace(encode(v)).second;
+		break;
+	default:
+		is_new = states.emplace(v).second;
+		break;
+	}
+	if (is_new)
+		++n;
+	return is_new;
+}
+
+/**
+ * Remove v from the set
+ * @param v
+ * @return bool true if v was in the set, false otherwise
+ */
+bool visible_state_set::erase(const visible_state& v) {
+	bool is_erased = false;
+	switch (storage) {
+	case mode::DENSE: {
+		const auto code = encode(v);
+		is_erased = bits[code];
+		bits[code] = false;
+	}
+		break;
+	case mode::HASHED:
+		is_erased = codes.erase(encode(v)) > 0;
+		break;
+	default:
+		is_erased = states.erase(v) > 0;
+		break;
+	}
+	if (is_erased)
+		--n;
+	return is_erased;
+}
+
+/**
+ * Determine whether v is in the set
+ * @param v
+ * @return bool
+ */
+bool visible_state_set::contains(const visible_state& v) const {
+	switch (storage) {
+	case mode::DENSE:
+		return bits[encode(v)];
+	case mode::HASHED:
+		return codes.find(encode(v)) != codes.end();
+	default:
+		return states.find(v) != states.end();
+	}
+}
+
+/**
+ * @return the visible states in the set, in ascending order
+ */
+vector<visible_state> visible_state_set::get_states() const {
+	vector<visible_state> result;
+	result.reserve(n);
+	switch (storage) {
+	case mode::DENSE: {
+		for (ulong code = 0; code < bits.size(); ++code) {
+			if (bits[code])
+				result.emplace_back(decode(code));
+		}
+	}
+		break;
+	case mode::HASHED: {
+		vector<ulong> sorted(codes.begin(), codes.end());
+		std::sort(sorted.begin(), sorted.end());
+		for (const auto code : sorted)
+			result.emplace_back(decode(code));
+	}
+		break;
+	default:
+		result.insert(result.end(), states.begin(), states.end());
+		break;
+	}
+	return result;
+}
+
+/**
+ * Encode v as an integer
+ * @param v
+ * @return ulong
+ */
+ulong visible_state_set::encode(const visible_state& v) const {
+	if (v.get_state() >= thread_visible_state::S)
+		throw cuba_runtime_error("Visible state out of the shared states!");
+	ulong code = v.get_state();
+	for (size_t i = 0; i < radix.size(); ++i) {
+		const auto l = v.get_local()[i];
+		const ulong digit =
+				l == alphabet::EPSILON ? radix[i] - 1 : ulong(l) - lo[i];
+		if (digit >= radix[i])
+			throw cuba_runtime_error("Visible state out of the alphabet!");
+		code = code * radix[i] + digit;
+	}
+	return code;
+}
+
+/**
+ * Decode an integer into a visible state
+ * @param code
+ * @return visible_state
+ */
+visible_state visible_state_set::decode(ulong code) const {
+	vector<pda_alpha> L(radix.size());
+	for (size_t i = radix.size(); i-- > 0;) {
+		const auto digit = code % radix[i];
+		L[i] = digit == radix[i] - 1 ? alphabet::EPSILON : lo[i] + digit;
+		code /= radix[i];
+	}
+	return visible_state(code, L);
+}
+
 /**
  * A constructor with a control state and the number of concurrent
  * components
@@ -172,13 +345,20 @@ visible_state explicit_state::top() {
 	return visible_state(s, L);
 }
 
+const id_thread explicit_state_tid::NO_THREAD =
+		std::numeric_limits<id_thread>::max();
+
+const id_action explicit_state_tid::NO_ACTION =
+		std::numeric_limits<id_action>::max();
+
 /**
  *
  * @param s
  * @param n
  */
 explicit_state_tid::explicit_state_tid(const pda_state& s, const size_n& n) :
-		explicit_state(s, n), id(0), k(0) {
+		explicit_state(s, n), id(0), k(0), preempted(NO_THREAD), summarized(false), action(
+				NO_ACTION), reached(nullptr) {
 
 }
 
@@ -191,7 +371,8 @@ explicit_state_tid::explicit_state_tid(const pda_state& s, const size_n& n) :
  */
 explicit_state_tid::explicit_state_tid(const id_thread& id,
 		const ctx_bound& k, const pda_state& s, const size_n& n) :
-		explicit_state(s, n), id(id), k(k) {
+		explicit_state(s, n), id(id), k(k), preempted(NO_THREAD), summarized(false), action(
+				NO_ACTION), reached(nullptr) {
 
 }
 
@@ -203,7 +384,8 @@ explicit_state_tid::explicit_state_tid(const id_thread& id,
  */
 explicit_state_tid::explicit_state_tid(const id_thread& id,
 		const pda_state& s, const stack_vec& W) :
-		explicit_state(s, W), id(id), k(0) {
+		explicit_state(s, W), id(id), k(0), preempted(NO_THREAD), summarized(false), action(
+				NO_ACTION), reached(nullptr) {
 
 }
 
@@ -216,19 +398,210 @@ explicit_state_tid::explicit_state_tid(const id_thread& id,
  */
 explicit_state_tid::explicit_state_tid(const id_thread& id,
 		const ctx_bound& k, const pda_state& s, const stack_vec& W) :
-		explicit_state(s, W), id(id), k(k) {
+		explicit_state(s, W), id(id), k(k), preempted(NO_THREAD), summarized(false), action(
+				NO_ACTION), reached(nullptr) {
 
 }
 
 explicit_state_tid::explicit_state_tid(const explicit_state_tid& c) :
 		explicit_state(c.get_state(), c.get_stacks()), id(c.get_thread_id()), k(
-				c.get_context_k()) {
+				c.get_context_k()), preempted(c.get_preempted()), summarized(
+				c.is_summarized()), action(c.get_action()), reached(
+				c.get_reached()) {
 
 }
 
 explicit_state_tid::~explicit_state_tid() {
 
 }
+
+/////////////////////////////////////////////////////////////////////////
+/// The packed form of explicit states
+///
+/////////////////////////////////////////////////////////////////////////
+
+/**
+ * Constructor: pack the shared state s and the stacks W
+ * @param s
+ * @param W
+ * @param width the number of bytes per stack symbol: see get_symbol_width
+ */
+packed_state::packed_state(const pda_state& s, const stack_vec& W,
+		const ushort width) :
+		bytes(), hash(0) {
+	encode(s);
+	for (const auto& w : W) {
+		encode(w.size());
+		for (const auto l : w)
+			encode_symbol(l, width);
+	}
+	hash = std::hash<string>()(bytes);
+}
+
+/**
+ * Constructor from the bytes of a packed state
+ * @param bytes
+ */
+packed_state::packed_state(const string& bytes) :
+		bytes(bytes), hash(std::hash<string>()(bytes)) {
+}
+
+/**
+ * destructor
+ */
+packed_state::~packed_state() {
+
+}
+
+/**
+ * @return the shared state
+ */
+pda_state packed_state::get_state() const {
+	size_t pos = 0;
+	return decode(bytes, pos);
+}
+
+/**
+ * Extract the visible state, reading only the top symbol of each stack
+ * @param width the number of bytes per stack symbol it is packed with
+ * @return visible_state
+ */
+visible_state packed_state::top(const ushort width) const {
+	size_t pos = 0;
+	const auto s = decode(bytes, pos);
+	vector<pda_alpha> L;
+	while (pos < bytes.size()) {
+		auto n = decode(bytes, pos);
+		if (n == 0) {
+			L.emplace_back(alphabet::EPSILON);
+			continue;
+		}
+		L.emplace_back(decode_symbol(bytes, pos, width));
+		if (width > 0) {
+			pos += (n - 1) * width;
+		} else {
+			while (--n > 0)
+				decode(bytes, pos);
+		}
+	}
+	return visible_state(s, L);
+}
+
+/**
+ * Restore the explicit state
+ * @param width the number of bytes per stack symbol it is packed with
+ * @return explicit_state
+ */
+explicit_state packed_state::unpack(const ushort width) const {
+	size_t pos = 0;
+	const auto s = decode(bytes, pos);
+	stack_vec W;
+	while (pos < bytes.size()) {
+		vector<pda_alpha> symbols(decode(bytes, pos));
+		for (auto& l : symbols)
+			l = decode_symbol(bytes, pos, width);
+		pda_stack w;
+		for (auto is = symbols.rbegin(); is != symbols.rend(); ++is)
+			w.push(*is);
+		W.emplace_back(w);
+	}
+	return explicit_state(s, W);
+}
+
+/**
+ * Choose the width of stack symbols: all the states packed together must
+ * use the same width
+ * @param max_alpha the largest stack symbol used by the CPDS
+ * @return 1 or 2 bytes per symbol, or 0 for varints
+ */
+ushort packed_state::get_symbol_width(const pda_alpha& max_alpha) {
+	/// symbols are shifted by one so that EPSILON becomes 0
+	const auto bound = uint64_t(max_alpha) + 1;
+	if (bound <= std::numeric_limits<uint8_t>::max())
+		return 1;
+	if (bound <= std::numeric_limits<uint16_t>::max())
+		return 2;
+	return 0;
+}
+
+/**
+ * Append v as a varint: 7 bits per byte, the high bit set on all bytes
+ * but the last one
+ * @param v
+ */
+void packed_state::encode(uint v) {
+	while (v >= 0x80) {
+		bytes.push_back(char((v & 0x7F) | 0x80));
+		v >>= 7;
+	}
+	bytes.push_back(char(v));
+}
+
+/**
+ * Append the stack symbol l
+ * @param l
+ * @param width
+ */
+void packed_state::encode_symbol(const pda_alpha& l, const ushort width) {
+	const uint v = l + 1; /// EPSILON is mapped to 0
+	switch (width) {
+	case 1:
+		if (v > std::numeric_limits<uint8_t>::max())
+			throw cuba_runtime_error("Stack symbol out of the alphabet!");
+		bytes.push_back(char(v));
+		break;
+	case 2:
+		if (v > std::numeric_limits<uint16_t>::max())
+			throw cuba_runtime_error("Stack symbol out of the alphabet!");
+		bytes.push_back(char(v & 0xFF));
+		bytes.push_back(char(v >> 8));
+		break;
+	default:
+		encode(v);
+		break;
+	}
+}
+
+/**
+ * Read a varint at pos, and move pos past it
+ * @param bytes
+ * @param pos
+ * @return uint
+ */
+uint packed_state::decode(const string& bytes, size_t& pos) {
+	uint v = 0;
+	for (uint shift = 0;; shift += 7) {
+		const auto b = uint8_t(bytes[pos++]);
+		v |= uint(b & 0x7F) << shift;
+		if (b < 0x80)
+			return v;
+	}
+}
+
+/**
+ * Read a stack symbol at pos, and move pos past it
+ * @param bytes
+ * @param pos
+ * @param width
+ * @return pda_alpha
+ */
+pda_alpha packed_state::decode_symbol(const string& bytes, size_t& pos,
+		const ushort width) {
+	uint v = 0;
+	switch (width) {
+	case 1:
+		v = uint8_t(bytes[pos++]);
+		break;
+	case 2:
+		v = uint8_t(bytes[pos]) | (uint(uint8_t(bytes[pos + 1])) << 8);
+		pos += 2;
+		break;
+	default:
+		v = decode(bytes, pos);
+		break;
+	}
+	return v - 1;
+}
 /////////////////////////////////////////////////////////////////////////
 /// The data structure for pushdown store automaton
 ///
@@ -244,7 +617,8 @@ explicit_state_tid::~explicit_state_tid() {
 store_automaton::store_automaton(const fsa_state_set& states,
 		const fsa_alphabet& alphabet, const fsa_delta& transitions,
 		const fsa_state_set& start, const fsa_state& accept) :
-		finite_automaton(states, alphabet, transitions, start, accept) {
+		finite_automaton(states, alphabet, transitions, start, accept), tops(
+				std::make_shared<top_cache>()) {
 }
 
 /**
@@ -254,18 +628,103 @@ store_automaton::~store_automaton() {
 
 }
 
-fsa_state store_automaton::interm_s = 0;
+/**
+ * Return the canonical form of the automaton: the transitions reachable
+ * from the start states, listed in a breadth-first order, where the states
+ * other than the shared states are renumbered in the order they are
+ * reached, followed by the accept state. The automata with the same
+ * canonical form are thus equal up to the names of their intermediate
+ * states. The converse does not always hold, as the transitions with the
+ * same label are visited in the order of the names of their destinations.
+ * @return string
+ */
+string store_automaton::get_canonical_form() const {
+	const auto& delta = get_transitions();
+	/// the new ids of the states reached, except the shared states
+	unordered_map<fsa_state, uint> ids;
+	queue<fsa_state> worklist;
+	auto id = [&](const fsa_state q) -> uint {
+		if (q < thread_visible_state::S)
+			return q;
+		const auto& ret = ids.emplace(q, thread_visible_state::S + ids.size());
+		if (ret.second)
+			worklist.emplace(q);
+		return ret.first->second;
+	};
+	string form;
+	auto append = [&form](const uint x) {
+		form.append(reinterpret_cast<const char*>(&x), sizeof(x));
+	};
+	/// the shared states with out-going transitions, in ascending order
+	vector<fsa_state> sources;
+	for (const auto& transs : delta) {
+		if (!transs.empty()
+				&& transs.front().get_src() < thread_visible_state::S)
+			sources.emplace_back(transs.front().get_src());
+	}
+	std::sort(sources.begin(), sources.end());
+	for (const auto q : sources)
+		worklist.emplace(q);
+	while (!worklist.empty()) {
+		const auto q = worklist.front();
+		worklist.pop();
+		const auto& transs = delta.get(q);
+		append(id(q));
+		append(transs.size());
+		for (const auto& t : transs) {
+			append(t.get_label());
+			append(id(t.get_dst()));
+		}
+	}
+	auto ifind = ids.find(get_accept());
+	append(ifind == ids.end() ? std::numeric_limits<uint>::max() : ifind->second);
+	return form;
+}
 
 /**
- *
- * @return
+ * Return the top symbols of the configurations from control state q: the
+ * labels of the transitions from the states reachable from q by epsilon
+ * transitions, epsilon included. They are computed on the first query.
+ * @param q
+ * @return the set of top symbols
+ */
+const set<pda_alpha>& store_automaton::get_tops(const pda_state q) const {
+	std::call_once(tops->computed, [this]() {this->compute_tops();});
+	return tops->tops[q];
+}
+
+/**
+ * Replace the transitions, and clear the top symbols computed for the
+ * ones replaced
+ * @param transitions
+ */
+void store_automaton::set_transitions(const fsa_delta& transitions) {
+	finite_automaton::set_transitions(transitions);
+	tops = std::make_shared<top_cache>();
+}
+
+/**
+ * Compute the top symbols from each control state, under call_once
  */
-fsa_state store_automaton::create_interm_state() {
-	if (interm_s == 0)
-		interm_s = thread_visible_state::S;
-	if (interm_s == std::numeric_limits<uint>::max())
-		throw cuba_runtime_error("intermediate state: overflow!");
-	return interm_s++;
+void store_automaton::compute_tops() const {
+	const auto& delta = get_transitions();
+	auto& _tops = tops->tops;
+	_tops.resize(thread_visible_state::S);
+	for (pda_state q = 0; q < thread_visible_state::S; ++q) {
+		/// the closure of q under epsilon transitions
+		unordered_set<fsa_state> closure { q };
+		vector<fsa_state> worklist { q };
+		while (!worklist.empty()) {
+			const auto p = worklist.back();
+			worklist.pop_back();
+			for (const auto& r : delta.get(p)) {
+				if (r.get_label() == alphabet::EPSILON
+						&& closure.emplace(r.get_dst()).second)
+					worklist.emplace_back(r.get_dst());
+				_tops[q].emplace(r.get_label());
+			}
+		}
+	}
 }
 
 /////////////////////////////////////////////////////////////////////////
@@ -301,4 +760,22 @@ symbolic_state::symbolic_state(const pda_state& g, const size_n&n,
 symbolic_state::~symbolic_state() {
 
 }
+
+/**
+ * Return the canonical form of the symbolic state: the shared state and
+ * the canonical forms of its automata, each preceded by its length. The
+ * symbolic states with the same canonical form denote the same set of
+ * configurations.
+ * @return string
+ */
+string symbolic_state::get_canonical_form() const {
+	string form(reinterpret_cast<const char*>(&q), sizeof(q));
+	for (const auto& A : W) {
+		const auto& _form = A.get_canonical_form();
+		const uint size = _form.size();
+		form.append(reinterpret_cast<const char*>(&size), sizeof(size));
+		form.append(_form);
+	}
+	return form;
+}
 } /* namespace ruba */
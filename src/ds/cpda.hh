@@ -132,6 +132,60 @@ inline bool operator!=(const visible_state& s1, const visible_state& s2) {
 	return !(s1 == s2);
 }
 
+/// the range [lo, hi] of the stack symbols of a thread
+using alpha_range = pair<pda_alpha, pda_alpha>;
+
+/**
+ * A set of visible states (s|l1,...,ln). Each visible state is encoded as
+ * a mixed-radix integer: the shared state s is the most significant digit,
+ * followed by one digit per thread, li - lo_i for a symbol li, or
+ * hi_i - lo_i + 1 for an empty stack. The codes keep the order of visible
+ * states.
+ *
+ * The set is a dense bitset when there are few codes, a hash set of the
+ * codes when a code fits in 64 bits, and a set of visible states
+ * otherwise.
+ */
+class visible_state_set {
+public:
+	visible_state_set(const vector<alpha_range>& ranges);
+	~visible_state_set();
+
+	bool insert(const visible_state& v);
+	bool erase(const visible_state& v);
+	bool contains(const visible_state& v) const;
+	vector<visible_state> get_states() const;
+
+	size_t size() const {
+		return n;
+	}
+
+	bool empty() const {
+		return n == 0;
+	}
+
+private:
+	/// the smallest symbol of each thread
+	vector<pda_alpha> lo;
+	/// the radix of each thread's digit
+	vector<ulong> radix;
+	/// the storage in use
+	enum class mode {
+		DENSE, HASHED, TREE
+	} storage;
+	vector<bool> bits;
+	unordered_set<ulong> codes;
+	set<visible_state> states;
+	/// the number of visible states in the set
+	size_t n;
+
+	/// up to 2^22 codes are stored in a bitset, i.e., 512KB
+	static const ulong MAX_DENSE_CODES;
+
+	ulong encode(const visible_state& v) const;
+	visible_state decode(ulong code) const;
+};
+
 /**
  * Explicit state of a CPDS is of the form (s|w1,...,wn). It is an element
  * of Qx(L*)^n, where n represents a number of threads
@@ -225,6 +279,8 @@ inline bool operator!=(const explicit_state& g1, const explicit_state& g2) {
 	return !(g1 == g2);
 }
 
+class packed_state;
+
 /**
  * Explicit state -- with thread id and contexts -- of a CPDS is of the form
  * (id,k,s|w1,...,wn). It is an element of Q x (L*)^n, where n represents a
@@ -254,11 +310,58 @@ public:
 		return id;
 	}
 
+	id_thread get_preempted() const {
+		return preempted;
+	}
+
+	void set_preempted(const id_thread& preempted) {
+		this->preempted = preempted;
+	}
+
+	bool is_summarized() const {
+		return summarized;
+	}
+
+	void set_summarized(const bool summarized) {
+		this->summarized = summarized;
+	}
+
+	id_action get_action() const {
+		return action;
+	}
+
+	void set_action(const id_action& action) {
+		this->action = action;
+	}
+
+	const packed_state* get_reached() const {
+		return reached;
+	}
+
+	void set_reached(const packed_state* reached) {
+		this->reached = reached;
+	}
+
+	/// the value of preempted when no thread is preempted
+	static const id_thread NO_THREAD;
+	/// the value of action when current state is not reached by one action
+	static const id_action NO_ACTION;
+
 private:
 	/// to mark the active thread that reach current state
 	id_thread id;
 	/// the number of contexts used to reach current state
 	ctx_bound k;
+	/// the thread preempted by the context switch that reached current
+	/// state, if that switch preserved the shared state
+	id_thread preempted;
+	/// whether the successors of current state in the same context have
+	/// been produced by a procedure summary already
+	bool summarized;
+	/// the action of thread id that reached current state
+	id_action action;
+	/// the copy of current state stored in the reached states, if any
+	const packed_state* reached;
 };
 
 /**
@@ -335,6 +438,72 @@ inline bool operator!=(const explicit_state_tid& g1,
 	return !(g1 == g2);
 }
 
+/**
+ * Packed explicit state: the explicit state (s|w1,...,wn) is stored in one
+ * contiguous buffer, as the shared state followed by each stack, prefixed
+ * with its length and listed from top to bottom. The shared state and the
+ * lengths are varints; the stack symbols take 1 or 2 bytes when the
+ * alphabet allows it, and are varints otherwise. The hash of the buffer
+ * is computed once, on construction.
+ *
+ * The width of the stack symbols is not stored in the buffer: it is given
+ * by the owner of the states, e.g., a reached_set, which packs and reads
+ * all of its states with the same width.
+ *
+ * The buffer is a string: the small states, which are most of them, fit
+ * in its inline storage and need no heap allocation at all.
+ */
+class packed_state {
+public:
+	packed_state(const pda_state& s, const stack_vec& W, const ushort width);
+	explicit packed_state(const string& bytes);
+	~packed_state();
+
+	pda_state get_state() const;
+	visible_state top(const ushort width) const;
+	explicit_state unpack(const ushort width) const;
+
+	const string& get_bytes() const {
+		return bytes;
+	}
+
+	size_t get_hash() const {
+		return hash;
+	}
+
+	static ushort get_symbol_width(const pda_alpha& max_alpha);
+
+private:
+	string bytes;
+	size_t hash;
+
+	void encode(uint v);
+	void encode_symbol(const pda_alpha& l, const ushort width);
+	static uint decode(const string& bytes, size_t& pos);
+	static pda_alpha decode_symbol(const string& bytes, size_t& pos,
+			const ushort width);
+};
+
+/**
+ * overloading the operator ==, return true if g1 == g2 and false otherwise
+ * @param g1
+ * @param g2
+ * @return bool
+ */
+inline bool operator==(const packed_state& g1, const packed_state& g2) {
+	return g1.get_hash() == g2.get_hash() && g1.get_bytes() == g2.get_bytes();
+}
+
+/**
+ * overloading the operator !=, return true if g1 != g2 and false otherwise
+ * @param g1
+ * @param g2
+ * @return bool
+ */
+inline bool operator!=(const packed_state& g1, const packed_state& g2) {
+	return !(g1 == g2);
+}
+
 
 /**
  *
@@ -343,11 +512,13 @@ inline bool operator!=(const explicit_state_tid& g1,
  *  - states: this contains only intermediate states and accept states,
  *    no start states;
  *  - start: this contains only start states;
- *  - accept: the accept state is a state. Its id is defined between the
- *    IDs of start states and those of intermediate states, e.g., initial
- *    0..5, accept 6, states 7..9
+ *  - accept: the accept state is a state.
  *
- *  - a static variable interm_s: to generate an intermediate state
+ * The states of each automaton are numbered densely, 0..|Q|-1: the start
+ * states are control states, and keep their ids 0..S-1 in the PDS; the
+ * intermediate states, the accept state included, are numbered from S on.
+ * Each automaton owns its ids, so that automata are built independently,
+ * e.g., by several threads at once.
  */
 class store_automaton: public finite_automaton {
 public:
@@ -356,9 +527,24 @@ public:
 			const fsa_state& accept);
 	~store_automaton();
 
-	static fsa_state create_interm_state();
+	string get_canonical_form() const;
+	const set<pda_alpha>& get_tops(const pda_state q) const;
+	void set_transitions(const fsa_delta& transitions);
+
 private:
-	static fsa_state interm_s;
+	/// the top symbols from each control state, computed for all control
+	/// states at once on the first query
+	struct top_cache {
+		std::once_flag computed;
+		vector<set<pda_alpha>> tops;
+	};
+
+	/// it's shared by the copies of the automaton until their transitions
+	/// are replaced, and the copies may be queried by several threads at
+	/// once: the first query fills it, the others wait until it's filled
+	shared_ptr<top_cache> tops;
+
+	void compute_tops() const;
 };
 
 /**
@@ -381,6 +567,8 @@ public:
 		return W;
 	}
 
+	string get_canonical_form() const;
+
 private:
 	/// a share state or control state
 	pda_state q;
@@ -427,4 +615,15 @@ enum class sequence {
 }
 /* namespace ruba */
 
+namespace std {
+/**
+ * hash function of packed states: the hash is cached in the state
+ */
+template<> struct hash<ruba::packed_state> {
+	size_t operator()(const ruba::packed_state& c) const {
+		return c.get_hash();
+	}
+};
+} /* namespace std */
+
 #endif /* DS_CPDA_HH_ */
@@ -38,6 +38,155 @@ fsa_transition::~fsa_transition() {
 
 }
 
+const vector<fsa_transition> fsa_delta::NO_TRANSITION;
+
+/**
+ * constructor: no transition
+ */
+fsa_delta::fsa_delta() :
+		ids(), adj(), n(0), bitmap(1, 0), bit_mask(63) {
+}
+
+/**
+ * destructor
+ */
+fsa_delta::~fsa_delta() {
+}
+
+/**
+ * Insert transition t. It returns true if t is new, and false otherwise.
+ * @param t
+ * @return bool
+ */
+bool fsa_delta::insert(const fsa_transition& t) {
+	const auto& ret = ids.emplace(t.get_src(), adj.size());
+	if (ret.second)
+		adj.emplace_back();
+	auto& transs = adj[ret.first->second];
+	const auto bit = get_bit(t);
+	auto pos = transs.end();
+	if (bitmap[bit >> 6] & (uint64_t(1) << (bit & 63))) {
+		/// t may be in the set: search it
+		pos = std::lower_bound(transs.begin(), transs.end(), t, is_before);
+		if (pos != transs.end() && *pos == t)
+			return false;
+	} else {
+		pos = std::upper_bound(transs.begin(), transs.end(), t, is_before);
+	}
+	transs.insert(pos, t);
+	++n;
+	/// keep the bitmap at least 8 times as large as the set
+	if ((n << 3) > bit_mask)
+		this->resize_bitmap();
+	else
+		this->set_bit(t);
+	return true;
+}
+
+/**
+ * Insert transition (src, label, dst). It returns true if it is new, and
+ * false otherwise.
+ * @param src
+ * @param dst
+ * @param label
+ * @return bool
+ */
+bool fsa_delta::emplace(const fsa_state src, const fsa_state dst,
+		const fsa_alpha label) {
+	return this->insert(fsa_transition(src, dst, label));
+}
+
+/**
+ * @param t
+ * @return true if t is in the set
+ */
+bool fsa_delta::contains(const fsa_transition& t) const {
+	const auto bit = get_bit(t);
+	if (!(bitmap[bit >> 6] & (uint64_t(1) << (bit & 63))))
+		return false;
+	const auto& transs = this->get(t.get_src());
+	auto pos = std::lower_bound(transs.begin(), transs.end(), t, is_before);
+	return pos != transs.end() && *pos == t;
+}
+
+/**
+ * @param q
+ * @return the out-going transitions of q, sorted by label
+ */
+const vector<fsa_transition>& fsa_delta::get(const fsa_state q) const {
+	auto ifind = ids.find(q);
+	if (ifind == ids.end())
+		return NO_TRANSITION;
+	return adj[ifind->second];
+}
+
+/**
+ * Remove the out-going transitions of q. The bitmap is rebuilt, so that
+ * their bits are cleared; q keeps its id, with no transition.
+ * @param q
+ */
+void fsa_delta::erase(const fsa_state q) {
+	auto ifind = ids.find(q);
+	if (ifind == ids.end() || adj[ifind->second].empty())
+		return;
+	n -= adj[ifind->second].size();
+	adj[ifind->second].clear();
+	this->set_bits();
+}
+
+/**
+ * @param t
+ * @return the bit of t in the bitmap
+ */
+size_t fsa_delta::get_bit(const fsa_transition& t) const {
+	size_t seed = t.get_src();
+	algs::hash_combine(seed, t.get_dst());
+	algs::hash_combine(seed, t.get_label());
+	seed *= 0x9e3779b97f4a7c15;
+	return (seed ^ (seed >> 32)) & bit_mask;
+}
+
+/**
+ * Set the bit of t in the bitmap
+ * @param t
+ */
+void fsa_delta::set_bit(const fsa_transition& t) {
+	const auto bit = get_bit(t);
+	bitmap[bit >> 6] |= uint64_t(1) << (bit & 63);
+}
+
+/**
+ * Double the bitmap, and set the bits of all transitions again
+ */
+void fsa_delta::resize_bitmap() {
+	bitmap.resize(bitmap.size() << 1);
+	bit_mask = (bitmap.size() << 6) - 1;
+	this->set_bits();
+}
+
+/**
+ * Clear the bitmap, and set the bits of all transitions again
+ */
+void fsa_delta::set_bits() {
+	std::fill(bitmap.begin(), bitmap.end(), 0);
+	for (const auto& transs : adj)
+		for (const auto& t : transs)
+			this->set_bit(t);
+}
+
+/**
+ * The order of the out-going transitions of a state: by label, then by
+ * destination
+ * @param r1
+ * @param r2
+ * @return true if r1 is before r2
+ */
+bool fsa_delta::is_before(const fsa_transition& r1, const fsa_transition& r2) {
+	if (r1.get_label() != r2.get_label())
+		return r1.get_label() < r2.get_label();
+	return r1.get_dst() < r2.get_dst();
+}
+
 /**
  * constructor with the biggest state, the biggest input symbol (alpha),
  * the set of transitions and the accept state
@@ -50,7 +199,9 @@ fsa_transition::~fsa_transition() {
 finite_automaton::finite_automaton(const fsa_state_set& states,
 		const fsa_alphabet& alphabet, const fsa_delta& transitions,
 		const fsa_state_set& start, const fsa_state& accept) :
-		states(states), alphas(alphabet), transitions(transitions), ///
+		states(std::make_shared<const fsa_state_set>(states)), ///
+		alphas(std::make_shared<const fsa_alphabet>(alphabet)), ///
+		transitions(std::make_shared<const fsa_delta>(transitions)), ///
 		start(start), accept(accept) {
 
 }
@@ -66,7 +217,9 @@ finite_automaton::finite_automaton(const fsa_state_set& states,
 finite_automaton::finite_automaton(const fsa_state_set& states,
 		const fsa_alphabet& alphabet, const fsa_state_set& start,
 		const fsa_state& accept) :
-		states(states), alphas(alphabet), transitions(), ///
+		states(std::make_shared<const fsa_state_set>(states)), ///
+		alphas(std::make_shared<const fsa_alphabet>(alphabet)), ///
+		transitions(std::make_shared<const fsa_delta>()), ///
 		start(start), accept(accept) {
 
 }
@@ -121,8 +121,70 @@ inline bool operator!=(const fsa_transition& r1, const fsa_transition& r2) {
 	return !(r1 == r2);
 }
 
-/// the data structure of FSA transitions
-using fsa_delta = unordered_map<fsa_state, set<fsa_transition>>;
+/**
+ * The data structure of FSA transitions, organized in adjacency lists. The
+ * source states are renumbered densely, in the order they get out-going
+ * transitions, and the out-going transitions of each state are kept in a
+ * vector sorted by label, then by destination. A bitmap, indexed by the
+ * hash of the transitions, answers most membership queries of saturation
+ * procedures without searching the vectors: a transition whose bit is
+ * unset is not in the set.
+ */
+class fsa_delta {
+public:
+	fsa_delta();
+	~fsa_delta();
+
+	bool insert(const fsa_transition& t);
+	bool emplace(const fsa_state src, const fsa_state dst,
+			const fsa_alpha label);
+	bool contains(const fsa_transition& t) const;
+	const vector<fsa_transition>& get(const fsa_state q) const;
+	void erase(const fsa_state q);
+
+	/**
+	 * @return the number of transitions
+	 */
+	size_t size() const {
+		return n;
+	}
+
+	/**
+	 * @return true if there is no transition
+	 */
+	bool empty() const {
+		return n == 0;
+	}
+
+	/// iterate over the out-going transitions of each source state
+	vector<vector<fsa_transition>>::const_iterator begin() const {
+		return adj.begin();
+	}
+
+	vector<vector<fsa_transition>>::const_iterator end() const {
+		return adj.end();
+	}
+
+private:
+	/// the dense id of each source state
+	unordered_map<fsa_state, uint> ids;
+	/// the out-going transitions of each source state, sorted by label
+	vector<vector<fsa_transition>> adj;
+	/// the number of transitions
+	size_t n;
+	/// the membership bitmap, and the number of its bits minus 1
+	vector<uint64_t> bitmap;
+	size_t bit_mask;
+
+	static const vector<fsa_transition> NO_TRANSITION;
+
+	size_t get_bit(const fsa_transition& t) const;
+	void set_bit(const fsa_transition& t);
+	void set_bits();
+	void resize_bitmap();
+
+	static bool is_before(const fsa_transition& r1, const fsa_transition& r2);
+};
 
 /**
  * Definition of finite automaton
@@ -139,15 +201,15 @@ public:
 	virtual ~finite_automaton();
 
 	const fsa_state_set& get_states() const {
-		return states;
+		return *states;
 	}
 
 	const fsa_alphabet& get_alphas() const {
-		return alphas;
+		return *alphas;
 	}
 
 	const fsa_delta& get_transitions() const {
-		return transitions;
+		return *transitions;
 	}
 
 	fsa_state_set get_start() const {
@@ -158,19 +220,33 @@ public:
 		this->start = initials;
 	}
 
+	void set_states(const fsa_state_set& states) {
+		this->states = std::make_shared<const fsa_state_set>(states);
+	}
+
+	void set_transitions(const fsa_delta& transitions) {
+		this->transitions = std::make_shared<const fsa_delta>(transitions);
+	}
+
 	fsa_state get_accept() const {
 		return accept;
 	}
 
+	void set_accept(const fsa_state accept) {
+		this->accept = accept;
+	}
+
 	bool empty() const {
-		return states.size() == 0 || transitions.size() == 0;
+		return states->empty() || transitions->empty();
 	}
 
 private:
-	fsa_state_set states;  /// the finite set of states
-	fsa_alphabet alphas;   /// the finite set of symbols
-	fsa_delta transitions; /// the finite set of transitions, organized
-						   /// in adjacency list
+	/// the states, symbols and transitions are never modified once the
+	/// automaton is built, so they are shared by the copies of it
+	shared_ptr<const fsa_state_set> states;  /// the finite set of states
+	shared_ptr<const fsa_alphabet> alphas;   /// the finite set of symbols
+	/// the finite set of transitions, organized in adjacency list
+	shared_ptr<const fsa_delta> transitions;
 	fsa_state_set start;  /// the set of start states, it's a subset
 						  /// of states
 	fsa_state accept;  /// the set of accept states, it's a subset of states
@@ -229,8 +305,8 @@ inline ostream& operator<<(ostream& os, const finite_automaton& fsa) {
 	os << "}\n";
 	os << "F = { " << fsa.get_accept() << "}\n";
 	os << "D = {\n";
-	for (auto p : fsa.get_transitions()) {
-		for (auto r : p.second)
+	for (const auto& transs : fsa.get_transitions()) {
+		for (const auto& r : transs)
 			os << string(4, ' ') << r << "\n";
 	}
 	os << "}";
@@ -26,8 +26,10 @@ generator::generator(const string& initl,
 				vector<set<visible_state>>(thread_visible_state::S)), approx_Z(
 				vector<set<visible_state>>(thread_visible_state::S)), generators_for_dynamic_bound(
 				vector<set<visible_state>>(thread_visible_state::S)), initl_tau(
-				parser::parse_input_cfg(initl)), CPDA(CPDA), CFSM(CFSM), number_of_image_calls(
+				parser::parse_input_cfg(initl)), CPDA(CPDA), CFSM(CFSM), sym(), number_of_image_calls(
 				0) {
+	if (flags::OPT_SYMMETRY)
+		sym = symmetry(CPDA, initl_tau, parser::pop_candiate_sets);
 	context_insensitive();
 }
 
@@ -117,6 +119,10 @@ deque<explicit_state> generator::step(const explicit_state& tau) {
 	for (size_t tid = 0; tid < W.size(); ++tid) {
 		step(q, W, tid, successors);
 	}
+	if (!sym.empty()) {
+		for (auto& _tau : successors)
+			_tau = sym.canonicalize(_tau);
+	}
 	return successors;
 }
 
@@ -126,43 +132,37 @@ void generator::step(const pda_state& q, const stack_vec& W, const uint tid,
 		return;
 	}
 
-	const thread_visible_state src(q, W[tid].top());
-	const auto ifind = CPDA[tid].get_program().find(src);
-	if (ifind == CPDA[tid].get_program().end())
+	const auto& moves = CPDA[tid].get_moves(q, W[tid].top());
+	if (moves.empty())
 		return;
 
-	for (const auto rid : ifind->second) { /// rid: transition id
-		const auto& r = CPDA[tid].get_actions()[rid];
-		const auto& dst = r.get_dst();
-
-		auto _W = W; /// duplicate the stacks in current global conf.
+	for (const auto& m : moves) {
+		auto _W = W; /// share the stacks in current global conf.
 
-		switch (r.get_oper_type()) {
+		switch (m.op) {
 		case type_stack_operation::PUSH: { /// push operation
 			_W[tid].pop();
-			for (auto is = dst.get_stack().get_worklist().rbegin();
-					is != dst.get_stack().get_worklist().rend(); ++is) {
-				_W[tid].push(*is);
-			}
+			_W[tid].push(m.below);
+			_W[tid].push(m.top);
 			if (_W[tid].size() == flags::OPT_Z_APPROXIMATION_BOUND + 1) {
 				_W[tid].pop_back();
 			}
-			successors.emplace_back(dst.get_state(), _W);
+			successors.emplace_back(m.dst, _W);
 		}
 			break;
 		case type_stack_operation::POP: { /// pop operation
 			if (_W[tid].pop()) {
-				const explicit_state successor(dst.get_state(), _W);
+				const explicit_state successor(m.dst, _W);
 				successors.push_back(successor);
-				generators_for_dynamic_bound[dst.get_state()].insert(
+				generators_for_dynamic_bound[m.dst].insert(
 						top_mapping(successor));
 			}
 			if (_W[tid].size() == flags::OPT_Z_APPROXIMATION_BOUND - 1) {
 				for (const auto alpha : parser::pop_candiate_sets[tid]) {
 					_W[tid].push_back(alpha);
-					const explicit_state successor(dst.get_state(), _W);
+					const explicit_state successor(m.dst, _W);
 					successors.push_back(successor);
-					generators_for_dynamic_bound[dst.get_state()].insert(
+					generators_for_dynamic_bound[m.dst].insert(
 							top_mapping(successor));
 					_W[tid].pop_back(); /// Recover the stack
 				}
@@ -170,8 +170,8 @@ void generator::step(const pda_state& q, const stack_vec& W, const uint tid,
 		}
 			break;
 		default: { /// overwrite operation
-			if (_W[tid].overwrite(dst.get_stack().top())) {
-				successors.emplace_back(dst.get_state(), _W);
+			if (_W[tid].overwrite(m.top)) {
+				successors.emplace_back(m.dst, _W);
 			}
 		}
 			break;
@@ -272,7 +272,7 @@ visible_state generator::top_mapping(const explicit_state& tau) {
 		else
 			W[i] = tau.get_stacks()[i].top();
 	}
-	return visible_state(tau.get_state(), W);
+	return sym.canonicalize(visible_state(tau.get_state(), W));
 }
 
 /**
@@ -9,6 +9,7 @@
 #define DS_GENERATOR_HH_
 
 #include "parsers.hh"
+#include "symmetry.hh"
 
 namespace ruba {
 
@@ -37,6 +38,8 @@ private:
 	const explicit_state initl_tau;
 	concurrent_pushdown_automata CPDA;
 	concurrent_finite_machine CFSM;
+	/// the interchangeable threads, if symmetry reduction is enabled
+	symmetry sym;
 
 	void context_insensitive();
 
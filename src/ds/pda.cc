@@ -17,7 +17,8 @@ const char alphabet::OPT_EPSILON = '-';
  * constructor with default parameters
  */
 pushdown_automaton::pushdown_automaton() :
-		states(), alphas(), actions(), program() {
+		states(), alphas(), actions(), program(), lo(0), width(
+				1), rows(), moves(), sparse_rows(), finite_context(-1) {
 
 }
 
@@ -32,7 +33,9 @@ pushdown_automaton::pushdown_automaton() :
 pushdown_automaton::pushdown_automaton(const set<pda_state>& states,
 		const set<pda_alpha>& alphas, const vector<pda_action>& actions,
 		const adj_list& program) :
-		states(states), alphas(alphas), actions(actions), program(program) {
+		states(states), alphas(alphas), actions(actions), program(program), lo(
+				0), width(1), rows(), moves(), sparse_rows(), finite_context(-1) {
+	build_moves();
 }
 
 /**
@@ -41,4 +44,277 @@ pushdown_automaton::pushdown_automaton(const set<pda_state>& states,
 pushdown_automaton::~pushdown_automaton() {
 }
 
+const ulong pushdown_automaton::MAX_DENSE_ROWS = 1UL << 24;
+
+/**
+ * Return the moves from the thread visible state (q, l), in the order of
+ * the adjacency list
+ * @param q
+ * @param l
+ * @return pda_move_range
+ */
+pda_move_range pushdown_automaton::get_moves(const pda_state& q,
+		const pda_alpha& l) const {
+	ulong r = 0;
+	if (!get_row(q, l, r))
+		return pda_move_range(nullptr, nullptr);
+	if (rows.empty()) {
+		const auto ifind = sparse_rows.find(r);
+		if (ifind == sparse_rows.end())
+			return pda_move_range(nullptr, nullptr);
+		return pda_move_range(moves.data() + ifind->second.first,
+				moves.data() + ifind->second.second);
+	}
+	return pda_move_range(moves.data() + rows[r], moves.data() + rows[r + 1]);
+}
+
+/**
+ * Build the compressed-sparse-row form of the program
+ */
+void pushdown_automaton::build_moves() {
+	/// step 1: the range of rows
+	pda_state max_q = 0;
+	pda_alpha max_l = 0;
+	lo = std::numeric_limits<pda_alpha>::max();
+	for (const auto& p : program) {
+		max_q = std::max(max_q, p.first.get_state());
+		if (p.first.get_alpha() != alphabet::EPSILON) {
+			lo = std::min(lo, p.first.get_alpha());
+			max_l = std::max(max_l, p.first.get_alpha());
+		}
+	}
+	if (lo > max_l)
+		lo = max_l = 0;
+	/// one more column for EPSILON
+	width = ulong(max_l - lo) + 2;
+	const ulong n_rows = (ulong(max_q) + 1) * width;
+
+	/// step 2: lay out the moves, grouped by their sources
+	moves.reserve(actions.size());
+	if (n_rows <= MAX_DENSE_ROWS)
+		rows.assign(n_rows + 1, 0);
+	for (const auto& p : program) {
+		ulong r = 0;
+		get_row(p.first.get_state(), p.first.get_alpha(), r);
+		const uint first = moves.size();
+		for (const auto rid : p.second) {
+			const auto& a = actions[rid];
+			const auto dst = a.get_dst();
+			const auto& w = dst.get_stack();
+			pda_move m { rid, a.get_oper_type(), dst.get_state(),
+					alphabet::EPSILON, alphabet::EPSILON };
+			auto iw = w.begin();
+			if (iw != w.end())
+				m.top = *iw++;
+			if (iw != w.end())
+				m.below = *iw;
+			moves.emplace_back(m);
+		}
+		if (rows.empty())
+			sparse_rows.emplace(r, std::make_pair(first, uint(moves.size())));
+		else
+			rows[r + 1] = moves.size() - first;
+	}
+	/// step 3: turn the row sizes into offsets
+	for (ulong r = 1; r < rows.size(); ++r)
+		rows[r] += rows[r - 1];
+}
+
+/**
+ * Determine if the finite context reachability holds, i.e., if the PDA
+ * reaches finitely many configurations from any configuration. The result
+ * is cached: the PDA must not be queried by several threads at once.
+ * @return bool
+ */
+bool pushdown_automaton::is_finite_context() const {
+	if (finite_context < 0)
+		finite_context = compute_finite_context() ? 1 : 0;
+	return finite_context == 1;
+}
+
+/**
+ * The finite context reachability fails iff the stack grows unboundedly,
+ * i.e., iff some head (q, a) reaches (q, a w) with w nonempty. These are
+ * the cycles through a push on the graph over the heads with the edges
+ *  - (q, a) -> (q', b) for a push (q, a) -> (q', b c), which grows W;
+ *  - (q, a) -> (q', b) for an overwrite (q, a) -> (q', b);
+ *  - (q, a) -> (q'', c) for a push (q, a) -> (q', b c), where (q', b)
+ *    returns to q'', i.e., reaches (q'', e).
+ * The returns are saturated first; then the graph is split into strongly
+ * connected components by an iterative Tarjan's algorithm, in time linear
+ * in its edges: a push inside a component lies on a cycle.
+ * @return bool
+ */
+bool pushdown_automaton::compute_finite_context() const {
+	/// step 1: number the heads with moves, in the order of the program.
+	/// The heads with an empty stack are left out: they never move.
+	unordered_map<ulong, uint> ids;
+	for (const auto& p : program) {
+		ulong r = 0;
+		if (p.first.get_alpha() != alphabet::EPSILON
+				&& get_row(p.first.get_state(), p.first.get_alpha(), r))
+			ids.emplace(r, ids.size());
+	}
+	const auto n = ids.size();
+	/// the id of head (q, l), or n if (q, l) has no moves
+	auto id = [&](const pda_state q, const pda_alpha l) {
+		ulong r = 0;
+		if (l == alphabet::EPSILON || !get_row(q, l, r))
+			return uint(n);
+		const auto ifind = ids.find(r);
+		return ifind == ids.end() ? uint(n) : ifind->second;
+	};
+
+	/// step 2: saturate returns[i], the control states to which head i
+	/// returns. A head receives the returns of the heads it overwrites
+	/// to, in <into>, and the ones of (q'', c) once the head (q', b) it
+	/// pushes returns to q'', by <callers>.
+	vector<set<pda_state>> returns(n);
+	vector<vector<uint>> into(n);
+	vector<vector<pair<uint, pda_alpha>>> callers(n);
+	/// the edges of the graph: the growing ones, then the others
+	vector<pair<uint, uint>> pushes, edges;
+	deque<pair<uint, pda_state>> worklist;
+	auto add = [&](const uint i, const pda_state q) {
+		if (returns[i].emplace(q).second)
+			worklist.emplace_back(i, q);
+	};
+	for (const auto& p : program) {
+		const auto i = id(p.first.get_state(), p.first.get_alpha());
+		if (i == n)
+			continue;
+		for (const auto& m : get_moves(p.first.get_state(),
+				p.first.get_alpha())) {
+			switch (m.op) {
+			case type_stack_operation::PUSH: {
+				const auto j = id(m.dst, m.top);
+				if (j == n)
+					break;
+				pushes.emplace_back(i, j);
+				callers[j].emplace_back(i, m.below);
+			}
+				break;
+			case type_stack_operation::POP: {
+				add(i, m.dst);
+			}
+				break;
+			default: {
+				const auto j = id(m.dst, m.top);
+				if (j == n)
+					break;
+				edges.emplace_back(i, j);
+				into[j].emplace_back(i);
+			}
+				break;
+			}
+		}
+	}
+	set<pair<uint, uint>> summaries;
+	while (!worklist.empty()) {
+		const auto r = worklist.front();
+		worklist.pop_front();
+		for (const auto i : into[r.first])
+			add(i, r.second);
+		for (const auto& c : callers[r.first]) {
+			const auto k = id(r.second, c.second);
+			if (k == n || !summaries.emplace(c.first, k).second)
+				continue;
+			edges.emplace_back(c.first, k);
+			into[k].emplace_back(c.first);
+			const vector<pda_state> qs(returns[k].begin(), returns[k].end());
+			for (const auto q : qs)
+				add(c.first, q);
+		}
+	}
+
+	/// step 3: the graph in compressed-sparse-row form
+	vector<uint> first(n + 1, 0), succ;
+	for (const auto& e : pushes)
+		++first[e.first + 1];
+	for (const auto& e : edges)
+		++first[e.first + 1];
+	for (size_t i = 1; i <= n; ++i)
+		first[i] += first[i - 1];
+	succ.resize(first[n]);
+	{
+		auto next = first;
+		for (const auto& e : pushes)
+			succ[next[e.first]++] = e.second;
+		for (const auto& e : edges)
+			succ[next[e.first]++] = e.second;
+	}
+
+	/// step 4: Tarjan's algorithm, with an explicit call stack of
+	/// (head, next successor)
+	const uint UNVISITED = std::numeric_limits<uint>::max();
+	vector<uint> index(n, UNVISITED), low(n, 0), component(n, UNVISITED);
+	vector<bool> on_stack(n, false);
+	vector<uint> S;
+	vector<pair<uint, uint>> calls;
+	uint counter = 0, n_components = 0;
+	for (uint root = 0; root < n; ++root) {
+		if (index[root] != UNVISITED)
+			continue;
+		calls.emplace_back(root, first[root]);
+		index[root] = low[root] = counter++;
+		S.emplace_back(root), on_stack[root] = true;
+		while (!calls.empty()) {
+			auto& call = calls.back();
+			const auto v = call.first;
+			if (call.second < first[v + 1]) {
+				const auto w = succ[call.second++];
+				if (index[w] == UNVISITED) {
+					index[w] = low[w] = counter++;
+					S.emplace_back(w), on_stack[w] = true;
+					calls.emplace_back(w, first[w]);
+				} else if (on_stack[w]) {
+					low[v] = std::min(low[v], index[w]);
+				}
+				continue;
+			}
+			/// v is done: pop its component if it's the root of one
+			if (low[v] == index[v]) {
+				uint w = 0;
+				do {
+					w = S.back();
+					S.pop_back(), on_stack[w] = false;
+					component[w] = n_components;
+				} while (w != v);
+				++n_components;
+			}
+			calls.pop_back();
+			if (!calls.empty()) {
+				const auto u = calls.back().first;
+				low[u] = std::min(low[u], low[v]);
+			}
+		}
+	}
+
+	/// step 5: a push inside a component grows the stack unboundedly
+	for (const auto& e : pushes) {
+		if (component[e.first] == component[e.second])
+			return false;
+	}
+	return true;
+}
+
+/**
+ * Compute the row of (q, l). It returns false if (q, l) has no row.
+ * @param q
+ * @param l
+ * @param r
+ * @return bool
+ */
+bool pushdown_automaton::get_row(const pda_state& q, const pda_alpha& l,
+		ulong& r) const {
+	ulong col = width - 1;
+	if (l != alphabet::EPSILON) {
+		if (l < lo || ulong(l) - lo >= width - 1)
+			return false;
+		col = l - lo;
+	}
+	r = ulong(q) * width + col;
+	return rows.empty() || r + 1 < rows.size();
+}
+
 } /* namespace ruba */
@@ -246,74 +246,214 @@ inline bool operator!=(const thread_visible_state& t1,
 }
 
 /**
- * Definition of the stack of PDA
+ * Definition of the stack of PDA. The stack is persistent: it is a list
+ * of immutable nodes, linked from the top to the bottom, and copies of a
+ * stack share all of their nodes. Push and overwrite allocate exactly one
+ * node, pop allocates none, and none of them touches the nodes shared
+ * with other stacks. Hence, duplicating a vector of stacks only copies
+ * the pointers to their top nodes.
  */
 template<typename T> class sstack {
+private:
+	/// a node of the list: a stack symbol and the rest of the stack
+	struct node {
+		node(const T& value, const shared_ptr<const node>& next) :
+				value(value), next(next) {
+		}
+		T value;
+		shared_ptr<const node> next;
+	};
+
 public:
+	/**
+	 * a forward iterator from the top to the bottom of the stack
+	 */
+	class const_iterator {
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const T*;
+		using reference = const T&;
+
+		const_iterator(const node* p = nullptr) :
+				p(p) {
+		}
+
+		const T& operator*() const {
+			return p->value;
+		}
+
+		const_iterator& operator++() {
+			p = p->next.get();
+			return *this;
+		}
+
+		const_iterator operator++(int) {
+			auto it = *this;
+			p = p->next.get();
+			return it;
+		}
+
+		bool operator==(const const_iterator& it) const {
+			return p == it.p;
+		}
+
+		bool operator!=(const const_iterator& it) const {
+			return p != it.p;
+		}
+
+	private:
+		const node* p;
+	};
+
 	inline sstack() :
-			worklist() {
+			head(), n(0) {
 	}
 
 	inline sstack(const deque<T>& worklist) :
-			worklist(worklist) {
+			head(), n(0) {
+		for (auto is = worklist.rbegin(); is != worklist.rend(); ++is)
+			this->push(*is);
 	}
 
-	inline ~sstack() {
+	inline sstack(const sstack<T>& w) = default;
+	inline sstack(sstack<T>&& w) = default;
+
+	inline sstack<T>& operator=(const sstack<T>& w) {
+		if (this != &w) {
+			auto _head = w.head; /// w may hold nodes of this stack
+			this->release();
+			head = std::move(_head), n = w.n;
+		}
+		return *this;
 	}
 
-	T top() {
-		return worklist.front();
+	inline sstack<T>& operator=(sstack<T>&& w) {
+		if (this != &w) {
+			auto _head = std::move(w.head);
+			this->release();
+			head = std::move(_head), n = w.n;
+			w.n = 0;
+		}
+		return *this;
+	}
+
+	inline ~sstack() {
+		this->release();
 	}
 
 	T top() const {
-		if (worklist.empty())
+		if (head == nullptr)
 			throw cuba_runtime_error("Stack is empty!");
-		return worklist.front();
+		return head->value;
 	}
 
 	void push(const T& _value) {
-		worklist.emplace_front(_value);
+		head = std::make_shared<const node>(_value, head), ++n;
+	}
+
+	/**
+	 * push all symbols of w onto the stack, such that the top of w becomes
+	 * the top of the stack
+	 * @param w
+	 */
+	void push(const sstack<T>& w) {
+		this->push(w.head.get());
 	}
 
 	size_t size() const {
-		return worklist.size();
+		return n;
 	}
 
 	bool pop() {
-		if (worklist.empty())
+		if (head == nullptr)
 			return false;
-		worklist.pop_front();
+		head = head->next, --n;
 		return true;
 	}
 
+	/**
+	 * remove the bottom of the stack. As the stack is linked from its top,
+	 * this rebuilds all nodes above the bottom.
+	 * @return bool
+	 */
 	bool pop_back() {
-		if (worklist.empty())
+		if (head == nullptr)
 			return false;
-		worklist.pop_back();
+		vector<T> symbols(this->begin(), this->end());
+		symbols.pop_back();
+		this->rebuild(symbols);
 		return true;
 	}
 
+	/**
+	 * add a symbol under the bottom of the stack. As the stack is linked
+	 * from its top, this rebuilds all nodes of the stack.
+	 * @param _value
+	 */
 	void push_back(const T& _value) {
-		worklist.emplace_back(_value);
+		vector<T> symbols(this->begin(), this->end());
+		symbols.push_back(_value);
+		this->rebuild(symbols);
 	}
 
 	bool overwrite(const T& _value) {
-		if (worklist.empty())
+		if (head == nullptr)
 			return false;
-		worklist[0] = _value;
+		head = std::make_shared<const node>(_value, head->next);
 		return true;
 	}
 
 	bool empty() const {
-		return worklist.empty();
+		return head == nullptr;
 	}
 
-	const deque<T>& get_worklist() const {
-		return worklist;
+	/**
+	 * @return true if this and w share the same list of nodes
+	 */
+	bool shares(const sstack<T>& w) const {
+		return head == w.head;
+	}
+
+	const_iterator begin() const {
+		return const_iterator(head.get());
+	}
+
+	const_iterator end() const {
+		return const_iterator();
 	}
 
 private:
-	deque<T> worklist;
+	shared_ptr<const node> head; /// the top node of the stack
+	size_t n; /// the number of symbols in the stack
+
+	/// push the symbols from p to the bottom, bottom first. It is used
+	/// to push the short stacks in the destinations of PDA actions.
+	void push(const node* p) {
+		vector<const node*> nodes;
+		for (; p != nullptr; p = p->next.get())
+			nodes.emplace_back(p);
+		for (auto ip = nodes.rbegin(); ip != nodes.rend(); ++ip)
+			this->push((*ip)->value);
+	}
+
+	void rebuild(const vector<T>& symbols) {
+		this->release();
+		for (auto is = symbols.rbegin(); is != symbols.rend(); ++is)
+			this->push(*is);
+	}
+
+	/// empty the stack, releasing the nodes owned only by it one by one:
+	/// releasing a deep stack through the destructors of its nodes would
+	/// recurse once per node
+	void release() {
+		while (head && head.use_count() == 1) {
+			auto next = head->next;
+			head = std::move(next);
+		}
+		head.reset(), n = 0;
+	}
 };
 
 /**
@@ -327,7 +467,7 @@ template<typename T> inline ostream& operator<<(ostream& os,
 	if (a.size() == 0) {
 		os << alphabet::OPT_EPSILON;
 	} else {
-		for (const T& s : a.get_worklist()) {
+		for (const T& s : a) {
 			if (s == alphabet::EPSILON)
 				os << alphabet::OPT_EPSILON;
 			else
@@ -345,10 +485,12 @@ template<typename T> inline ostream& operator<<(ostream& os,
  */
 template<typename T> inline bool operator<(const sstack<T>& a1,
 		const sstack<T>& a2) {
-	if (a1.get_worklist().size() == a2.get_worklist().size()) {
-		auto ia1 = a1.get_worklist().cbegin();
-		auto ia2 = a2.get_worklist().cbegin();
-		while (ia1 != a1.get_worklist().cend()) {
+	if (a1.size() == a2.size()) {
+		if (a1.shares(a2))
+			return false;
+		auto ia1 = a1.begin();
+		auto ia2 = a2.begin();
+		while (ia1 != a1.end()) {
 			if (*ia1 < *ia2) {
 				return true;
 			} else if (*ia1 > *ia2) {
@@ -359,7 +501,7 @@ template<typename T> inline bool operator<(const sstack<T>& a1,
 		}
 		return false;
 	}
-	return a1.get_worklist().size() < a2.get_worklist().size();
+	return a1.size() < a2.size();
 }
 
 /**
@@ -374,18 +516,19 @@ template<typename T> inline bool operator>(const sstack<T>& a1,
 }
 
 /**
- * overloading operator ==
+ * overloading operator ==. Two stacks are equal once their remaining
+ * parts share the same nodes.
  * @param a1
  * @param a2
  * @return bool
  */
 template<typename T> inline bool operator==(const sstack<T>& a1,
 		const sstack<T>& a2) {
-	if (a1.get_worklist().size() != a2.get_worklist().size())
+	if (a1.size() != a2.size())
 		return false;
-	auto ia1 = a1.get_worklist().cbegin();
-	auto ia2 = a2.get_worklist().cbegin();
-	while (ia1 != a1.get_worklist().cend()) {
+	auto ia1 = a1.begin();
+	auto ia2 = a2.begin();
+	while (ia1 != ia2) {
 		if (*ia1 != *ia2)
 			return false;
 		++ia1, ++ia2;
@@ -502,6 +645,46 @@ using id_action = uint;
 using adj_list = map<thread_visible_state, deque<id_action>>;
 using pda_action = transition<thread_visible_state, thread_state>;
 
+/**
+ * A pre-decoded action, as stored in the transition table of a PDA:
+ *   PUSH     : (s1, l1) -> (dst, top below)
+ *   POP      : (s1, l1) -> (dst, e)
+ *   OVERWRITE: (s1, l1) -> (dst, top)
+ */
+struct pda_move {
+	id_action id; /// the id of the action
+	type_stack_operation op;
+	pda_state dst;
+	pda_alpha top;
+	pda_alpha below;
+};
+
+/**
+ * A contiguous range of pda_moves
+ */
+class pda_move_range {
+public:
+	pda_move_range(const pda_move* first, const pda_move* last) :
+			first(first), last(last) {
+	}
+
+	const pda_move* begin() const {
+		return first;
+	}
+
+	const pda_move* end() const {
+		return last;
+	}
+
+	bool empty() const {
+		return first == last;
+	}
+
+private:
+	const pda_move* first;
+	const pda_move* last;
+};
+
 /**
  * Definition of pushdown automaton
  */
@@ -530,11 +713,36 @@ public:
 		return program;
 	}
 
+	pda_move_range get_moves(const pda_state& q, const pda_alpha& l) const;
+	bool is_finite_context() const;
+
 private:
 	set<pda_state> states; /// the set of control states
 	set<pda_alpha> alphas; /// the set of stack symbols
 	vector<pda_action> actions; /// the set of actions
 	adj_list program; /// store PDA in adjacency list
+
+	/// The same program in compressed-sparse-row form: the moves from
+	/// (q, l) are moves[rows[r]..rows[r+1]), where r = q * width + col(l),
+	/// col(l) = l - lo and col(EPSILON) = width - 1.
+	pda_alpha lo;
+	ulong width;
+	vector<uint> rows;
+	vector<pda_move> moves;
+	/// the rows used for huge alphabets, instead of the dense table: row
+	/// r is moves[sparse_rows[r].first..sparse_rows[r].second)
+	unordered_map<ulong, pair<uint, uint>> sparse_rows;
+
+	/// up to 2^24 rows are stored in a dense table, i.e., 64MB
+	static const ulong MAX_DENSE_ROWS;
+
+	/// whether the finite context reachability holds: computed on the
+	/// first query; it's -1 before
+	mutable short finite_context;
+
+	void build_moves();
+	bool get_row(const pda_state& q, const pda_alpha& l, ulong& r) const;
+	bool compute_finite_context() const;
 };
 
 /**
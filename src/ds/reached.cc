@@ -0,0 +1,441 @@
+/**
+ * reached.cc
+ *
+ * @date  : Oct 18, 2026
+ * @author: TODO
+ */
+
+#include "reached.hh"
+
+namespace ruba {
+
+/// the level of the duplicates of spilled states
+const size_k reached_set::DROPPED = std::numeric_limits<size_k>::max();
+
+/// the state given for the new states in bit-state mode, not stored
+const packed_state reached_set::HASHED(0, stack_vec(), 0);
+
+/// the number of bits set per state in bit-state mode
+const ushort reached_set::HASH_FUNCTIONS = 3;
+
+/**
+ * Constructor
+ * @param max_alpha the largest stack symbol of the CPDS
+ * @param memory_limit the memory limit in bytes, 0 if unlimited
+ * @param bitstate the log2 of the size in bits of the bit-state table, 0
+ *        if the states are stored
+ */
+reached_set::reached_set(const pda_alpha max_alpha, const size_t memory_limit,
+		const ushort bitstate) :
+		symbol_width(packed_state::get_symbol_width(max_alpha)), index(), R(), empty_level(thread_visible_state::S), memory_limit(
+				memory_limit), memory_used(0), run(
+				nullptr), spilled_size(0), spilled_k(0), dropped(), bit_table(), bit_mask(
+				0), bits_set(0), bitstate_size(0) {
+	if (bitstate > 0) {
+		bit_mask = (uint64_t(1) << bitstate) - 1;
+		bit_table.resize((bit_mask >> 6) + 1, 0);
+	}
+}
+
+/**
+ * destructor: the run file is removed once closed
+ */
+reached_set::~reached_set() {
+	if (run != nullptr)
+		std::fclose(run);
+}
+
+/**
+ * Insert explicit state c to R_k, as reached from the state parent by the
+ * action of thread tid. It returns nullptr if c has been reached in a
+ * level <= k, and the copy of c stored otherwise: in bit-state mode, c is
+ * not stored, and HASHED is returned instead. If c has been reached in a
+ * level > k, c is moved to R_k, and its stale copy is dropped by compact.
+ *
+ * The spilled levels are not looked at: see filter. A duplicate of a
+ * spilled state that has been dropped is known to be reached, though.
+ * @param c
+ * @param k
+ * @param parent
+ * @param tid
+ * @param action
+ * @return const packed_state*
+ */
+const packed_state* reached_set::insert(const explicit_state& c,
+		const size_k k, const packed_state* parent, const id_thread tid,
+		const id_action action) {
+	while (k >= R.size())
+		R.emplace_back(vector<reached_states>(thread_visible_state::S));
+	auto p = pack(c);
+	if (is_bitstate())
+		return insert(p) ? &HASHED : nullptr;
+	const reached_info info { parent, action, tid, k };
+	auto ifind = index.find(p);
+	if (ifind == index.end()) {
+		memory_used += footprint(p);
+		ifind = index.emplace(std::move(p), info).first;
+	} else if (ifind->second.k <= k || ifind->second.k == DROPPED) {
+		return nullptr;
+	} else {
+		ifind->second = info;
+	}
+	R[k][c.get_state()].emplace_back(&ifind->first);
+	return &ifind->first;
+}
+
+/**
+ * Determine if explicit state c has been reached in a level < k. The run
+ * and the bit-state table are not looked at: their levels are not kept.
+ * @param c
+ * @param k
+ * @return bool
+ */
+bool reached_set::is_reached_below(const explicit_state& c,
+		const size_k k) const {
+	if (is_bitstate())
+		return false;
+	auto ifind = index.find(pack(c));
+	return ifind != index.end() && ifind->second.k < k;
+}
+
+/**
+ * Find the copy of explicit state c stored in the index
+ * @param c
+ * @return the copy of c, nullptr if c is not in the index
+ */
+const packed_state* reached_set::find(const explicit_state& c) const {
+	auto ifind = index.find(pack(c));
+	return ifind == index.end() ? nullptr : &ifind->first;
+}
+
+/**
+ * Insert the packed state p to the bit-state table: the hash functions
+ * are derived from the hash of p by double hashing. It returns true if
+ * any of the bits of p was unset.
+ * @param p
+ * @return bool
+ */
+bool reached_set::insert(const packed_state& p) {
+	uint64_t h1 = p.get_hash();
+	/// the second hash scrambles the first one, by the finalizer of
+	/// splitmix64; it's odd so that the probed bits are distinct
+	uint64_t h2 = h1;
+	h2 = (h2 ^ (h2 >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	h2 = (h2 ^ (h2 >> 27)) * 0x94d049bb133111ebULL;
+	h2 = (h2 ^ (h2 >> 31)) | 1;
+	bool is_new = false;
+	for (ushort i = 0; i < HASH_FUNCTIONS; ++i, h1 += h2) {
+		const auto b = h1 & bit_mask;
+		auto& word = bit_table[b >> 6];
+		const auto bit = uint64_t(1) << (b & 63);
+		if ((word & bit) == 0) {
+			word |= bit;
+			++bits_set;
+			is_new = true;
+		}
+	}
+	if (is_new)
+		++bitstate_size;
+	return is_new;
+}
+
+/**
+ * Remove the stale states from R_k, i.e., the states that were reached
+ * again in a level lower than k after they had been added to R_k.
+ * @param k
+ */
+void reached_set::compact(const size_k k) {
+	if (k >= R.size())
+		return;
+	for (auto& states : R[k]) {
+		states.erase(
+				std::remove_if(states.begin(), states.end(),
+						[&](const packed_state* c) {
+							return index.at(*c).k != k;
+						}), states.end());
+	}
+}
+
+/**
+ * Spill the levels below k to the run file if the memory limit is
+ * exceeded. These levels are complete: a state is never moved to a level
+ * below the one being explored. The states kept whose parents are
+ * spilled lose their parents, as the spilled states are freed.
+ * @param k
+ */
+void reached_set::spill(const size_k k) {
+	if (memory_limit == 0 || memory_used <= memory_limit || spilled_k >= k
+			|| is_bitstate())
+		return;
+	/// step 1: collect the states to spill, sorted
+	vector<string> states;
+	unordered_set<const packed_state*> spilled;
+	for (auto it = index.begin(); it != index.end();) {
+		if (it->second.k < k) {
+			memory_used -= footprint(it->first);
+			states.emplace_back(it->first.get_bytes());
+			spilled.emplace(&it->first);
+			it = index.erase(it);
+		} else {
+			++it;
+		}
+	}
+	for (auto& p : index)
+		if (spilled.count(p.second.parent) > 0)
+			p.second.parent = nullptr;
+	for (size_k j = spilled_k; j < k && j < R.size(); ++j)
+		vector<reached_states>(R[j].size()).swap(R[j]);
+	spilled_k = k;
+	std::sort(states.begin(), states.end());
+
+	/// step 2: merge them with the current run into a new run
+	FILE* _run = std::tmpfile();
+	if (_run == nullptr)
+		throw cuba_runtime_error("Cannot create a run file for spilling!");
+	string bytes;
+	bool has_next = false;
+	if (run != nullptr) {
+		std::rewind(run);
+		has_next = read(run, bytes);
+	}
+	for (const auto& s : states) {
+		while (has_next && bytes < s) {
+			write(_run, bytes);
+			has_next = read(run, bytes);
+		}
+		write(_run, s);
+	}
+	while (has_next) {
+		write(_run, bytes);
+		has_next = read(run, bytes);
+	}
+	std::fflush(_run);
+	if (run != nullptr)
+		std::fclose(run);
+	run = _run;
+	spilled_size += states.size();
+}
+
+/**
+ * Determine which of the states are in the run: the states are sorted,
+ * and then merged with the run in one sequential scan
+ * @param states
+ * @return the membership of each state
+ */
+vector<bool> reached_set::lookup(const vector<packed_state>& states) const {
+	vector<size_t> order(states.size());
+	for (size_t i = 0; i < order.size(); ++i)
+		order[i] = i;
+	std::sort(order.begin(), order.end(), [&states](size_t i, size_t j) {
+		return states[i].get_bytes() < states[j].get_bytes();
+	});
+	vector<bool> is_spilled(states.size(), false);
+	std::rewind(run);
+	string s;
+	bool has_next = read(run, s);
+	for (const auto i : order) {
+		const auto& bytes = states[i].get_bytes();
+		while (has_next && s < bytes)
+			has_next = read(run, s);
+		if (!has_next)
+			break;
+		if (s == bytes)
+			is_spilled[i] = true;
+	}
+	return is_spilled;
+}
+
+/**
+ * Mark the state p, which has been reached in a spilled level, as dropped.
+ * Its copy in the index, if any, is a duplicate that has been inserted
+ * since.
+ * @param p
+ */
+void reached_set::drop(const packed_state& p) {
+	auto ifind = index.find(p);
+	if (ifind == index.end() || ifind->second.k == DROPPED)
+		return;
+	ifind->second.k = DROPPED;
+	dropped.emplace_back(&ifind->first);
+}
+
+/**
+ * Remove the dropped states from R and from the index
+ */
+void reached_set::purge() {
+	if (dropped.empty())
+		return;
+	for (size_k j = spilled_k; j < R.size(); ++j)
+		compact(j);
+	for (const auto p : dropped) {
+		auto ifind = index.find(*p);
+		memory_used -= footprint(ifind->first);
+		index.erase(ifind);
+	}
+	dropped.clear();
+}
+
+/**
+ * @return the number of reached states, including the spilled ones
+ */
+ulong reached_set::size() const {
+	return index.size() + spilled_size + bitstate_size;
+}
+
+/**
+ * Write the reached set to a checkpoint: the bit-state table, the spilled
+ * states, and the states of each level in the index, with their back-
+ * pointers given as positions in the file. It must not hold any dropped
+ * state, i.e., it's called after purge.
+ * @param file
+ */
+void reached_set::save(FILE* file) const {
+	/// the bit-state table
+	binary::write(file, bit_mask);
+	binary::write(file, bits_set);
+	binary::write(file, bitstate_size);
+	binary::write(file, bit_table.data(), bit_table.size());
+	/// the spilled states, in the order of the run
+	binary::write(file, spilled_k);
+	binary::write(file, spilled_size);
+	if (run != nullptr) {
+		std::rewind(run);
+		string bytes;
+		while (read(run, bytes))
+			binary::write_string(file, bytes);
+	}
+	/// the states in the index, level by level, skipping the stale copies
+	vector<const packed_state*> states;
+	unordered_map<const packed_state*, uint32_t> positions;
+	for (size_k j = spilled_k; j < R.size(); ++j) {
+		for (const auto& level : R[j]) {
+			for (const auto p : level) {
+				if (index.at(*p).k != j)
+					continue;
+				positions.emplace(p, states.size());
+				states.emplace_back(p);
+			}
+		}
+	}
+	binary::write(file, size_k(R.size()));
+	binary::write(file, uint64_t(states.size()));
+	for (const auto p : states) {
+		const auto& info = index.at(*p);
+		const auto ifind = positions.find(info.parent);
+		binary::write_string(file, p->get_bytes());
+		binary::write(file, info.k);
+		binary::write(file, info.tid);
+		binary::write(file, info.action);
+		binary::write(file,
+				ifind == positions.end() ?
+						std::numeric_limits<uint32_t>::max() : ifind->second);
+	}
+}
+
+/**
+ * Read the reached set from a checkpoint written by save. It must be
+ * empty, and be built with the same size of bit-state table.
+ * @param file
+ */
+void reached_set::load(FILE* file) {
+	/// the bit-state table
+	if (binary::read<uint64_t>(file) != bit_mask)
+		throw cuba_runtime_error(
+				"The checkpoint has another size of bit-state table!");
+	bits_set = binary::read<ulong>(file);
+	bitstate_size = binary::read<ulong>(file);
+	binary::read(file, bit_table.data(), bit_table.size());
+	/// the spilled states, written to a new run
+	spilled_k = binary::read<size_k>(file);
+	spilled_size = binary::read<ulong>(file);
+	if (spilled_size > 0) {
+		run = std::tmpfile();
+		if (run == nullptr)
+			throw cuba_runtime_error("Cannot create a run file for spilling!");
+		for (ulong i = 0; i < spilled_size; ++i)
+			write(run, binary::read_string(file));
+		std::fflush(run);
+	}
+	/// the states in the index
+	R.assign(binary::read<size_k>(file),
+			vector<reached_states>(thread_visible_state::S));
+	vector<const packed_state*> states(binary::read<uint64_t>(file));
+	vector<uint32_t> parents(states.size());
+	for (size_t i = 0; i < states.size(); ++i) {
+		packed_state p(binary::read_string(file));
+		reached_info info { nullptr, 0, 0, 0 };
+		info.k = binary::read<size_k>(file);
+		info.tid = binary::read<id_thread>(file);
+		info.action = binary::read<id_action>(file);
+		parents[i] = binary::read<uint32_t>(file);
+		if (info.k >= R.size())
+			throw cuba_runtime_error("Corrupted checkpoint!");
+		memory_used += footprint(p);
+		const auto q = p.get_state();
+		const auto it = index.emplace(std::move(p), info).first;
+		R[info.k][q].emplace_back(&it->first);
+		states[i] = &it->first;
+	}
+	/// the back-pointers, once all states are in place
+	for (size_t i = 0; i < states.size(); ++i) {
+		if (parents[i] < states.size())
+			index.at(*states[i]).parent = states[parents[i]];
+	}
+}
+
+/**
+ * @return the ratio of bits set in the bit-state table
+ */
+double reached_set::get_fill_ratio() const {
+	return is_bitstate() ? double(bits_set) / (double(bit_mask) + 1) : 0;
+}
+
+/**
+ * Estimate the probability that a new state is taken for a reached one
+ * in the bit-state table, as it is now: all of its bits are set already
+ * @return double
+ */
+double reached_set::get_omission_probability() const {
+	return std::pow(get_fill_ratio(), HASH_FUNCTIONS);
+}
+
+/**
+ * Estimate the memory used by a state in the index and in R
+ * @param p
+ * @return size_t
+ */
+size_t reached_set::footprint(const packed_state& p) {
+	return sizeof(std::pair<const packed_state, reached_info>)
+			+ 2 * sizeof(void*) + sizeof(const packed_state*)
+			+ p.get_bytes().size();
+}
+
+/**
+ * Read a length-prefixed state from file
+ * @param file
+ * @param bytes
+ * @return false at the end of file
+ */
+bool reached_set::read(FILE* file, string& bytes) {
+	uint32_t n = 0;
+	if (std::fread(&n, sizeof(n), 1, file) != 1)
+		return false;
+	bytes.resize(n);
+	if (n > 0 && std::fread(&bytes[0], 1, n, file) != n)
+		throw cuba_runtime_error("Corrupted run file!");
+	return true;
+}
+
+/**
+ * Write a length-prefixed state to file
+ * @param file
+ * @param bytes
+ */
+void reached_set::write(FILE* file, const string& bytes) {
+	const uint32_t n = bytes.size();
+	if (std::fwrite(&n, sizeof(n), 1, file) != 1
+			|| std::fwrite(bytes.data(), 1, n, file) != n)
+		throw cuba_runtime_error("Cannot write to the run file!");
+}
+
+} /* namespace ruba */
@@ -0,0 +1,216 @@
+/**
+ * reached.hh
+ *
+ * @date  : Oct 18, 2026
+ * @author: TODO
+ */
+
+#ifndef DS_REACHED_HH_
+#define DS_REACHED_HH_
+
+#include "cpda.hh"
+#include "binary.hh"
+
+namespace ruba {
+
+/// To store reached explicit states: each element points to a key of the
+/// hash index of a reached_set, which never moves while the key is in the
+/// index
+using reached_states = deque<const packed_state*>;
+
+/**
+ * A reached state, as stored in the hash index of a reached_set: the
+ * lowest level in which it has been reached, and how it has been reached
+ * there, i.e., the state it is a successor of, and the thread and action
+ * producing it. These back-pointers form a tree rooted in the initial
+ * state, along which a witness is rebuilt.
+ */
+struct reached_info {
+	const packed_state* parent;
+	id_action action;
+	id_thread tid;
+	size_k k;
+};
+
+/**
+ * The set of reached explicit states R = R_0, R_1, ..., where R_k holds
+ * the states reached with k contexts (or writes) but not fewer. Each state
+ * is stored once, in the packed form, in a hash index that maps it to the
+ * lowest level in which it has been reached; R_k lists the states of the
+ * level per shared state.
+ *
+ * External-memory mode: once the states kept in memory exceed a memory
+ * limit, the completed levels, i.e., the levels below the one being
+ * explored, are spilled to a run file on disk, which lists the packed
+ * states sorted by their bytes. A state is then inserted without looking
+ * at the run: the duplicates of spilled states are only detected later,
+ * in batches, by filter, which sorts a frontier and merges it with the
+ * run in one sequential scan, as the external BFS does.
+ *
+ * Bit-state mode: as the supertrace of SPIN, the states are not stored at
+ * all, but hashed by several hash functions into a bit table of a fixed
+ * size. A state is new if any of its bits is unset. A new state may thus
+ * be taken for a reached one, and omitted, but a reached state is never
+ * taken for a new one. The levels of the states are not kept either: a
+ * state is reached in the first level where it is inserted.
+ *
+ * All states are packed with the same width of stack symbols, chosen from
+ * the largest stack symbol of the CPDS: pack, unpack and top go through
+ * the reached set for this reason.
+ */
+class reached_set {
+public:
+	reached_set(const pda_alpha max_alpha, const size_t memory_limit = 0,
+			const ushort bitstate = 0);
+	~reached_set();
+
+	/**
+	 * @param c
+	 * @return the packed form of c
+	 */
+	packed_state pack(const explicit_state& c) const {
+		return packed_state(c.get_state(), c.get_stacks(), symbol_width);
+	}
+
+	/**
+	 * @param p
+	 * @return the explicit state packed in p
+	 */
+	explicit_state unpack(const packed_state& p) const {
+		return p.unpack(symbol_width);
+	}
+
+	/**
+	 * @param p
+	 * @return the visible state of the state packed in p
+	 */
+	visible_state top(const packed_state& p) const {
+		return p.top(symbol_width);
+	}
+
+	const packed_state* insert(const explicit_state& c, const size_k k,
+			const packed_state* parent = nullptr, const id_thread tid = 0,
+			const id_action action = explicit_state_tid::NO_ACTION);
+	bool is_reached_below(const explicit_state& c, const size_k k) const;
+	const packed_state* find(const explicit_state& c) const;
+	void compact(const size_k k);
+	void spill(const size_k k);
+	void purge();
+
+	/**
+	 * Remove from frontier the states already reached in the spilled
+	 * levels. Their duplicates stay in the index, marked as dropped, until
+	 * purge removes them from R and from the index.
+	 * @param frontier
+	 */
+	template<typename T> void filter(deque<T>& frontier) {
+		if (run == nullptr || frontier.empty())
+			return;
+		vector<packed_state> states;
+		states.reserve(frontier.size());
+		for (const auto& c : frontier)
+			states.emplace_back(pack(c));
+		const auto& is_spilled = lookup(states);
+		deque<T> _frontier;
+		for (size_t i = 0; i < frontier.size(); ++i) {
+			if (is_spilled[i])
+				drop(states[i]);
+			else
+				_frontier.emplace_back(std::move(frontier[i]));
+		}
+		frontier.swap(_frontier);
+	}
+
+	/**
+	 * @param k
+	 * @return R_k, empty if level k has been spilled or not reached
+	 */
+	const vector<reached_states>& get_level(const size_k k) const {
+		return k < R.size() ? R[k] : empty_level;
+	}
+
+	/**
+	 * @return the number of levels
+	 */
+	size_k get_levels() const {
+		return R.size();
+	}
+
+	/**
+	 * @param p a reached state stored in the index
+	 * @return how p has been reached
+	 */
+	const reached_info& get_info(const packed_state& p) const {
+		return index.at(p);
+	}
+
+	ulong size() const;
+
+	void save(FILE* file) const;
+	void load(FILE* file);
+
+	/**
+	 * @return true if the reached set is a bit-state table
+	 */
+	bool is_bitstate() const {
+		return !bit_table.empty();
+	}
+
+	double get_fill_ratio() const;
+	double get_omission_probability() const;
+
+	/**
+	 * @return the number of states spilled to disk
+	 */
+	ulong get_spilled_size() const {
+		return spilled_size;
+	}
+
+private:
+	/// the number of bytes per stack symbol of the packed states
+	ushort symbol_width;
+	/// the hash index over R
+	unordered_map<packed_state, reached_info> index;
+	/// the reached states of each level, kept in memory
+	vector<vector<reached_states>> R;
+	/// an empty level
+	vector<reached_states> empty_level;
+	/// the memory limit in bytes, 0 if unlimited
+	size_t memory_limit;
+	/// the estimated memory used by the index and R
+	size_t memory_used;
+	/// the sorted run of spilled states, nullptr if nothing is spilled
+	FILE* run;
+	/// the number of states in the run
+	ulong spilled_size;
+	/// the number of levels spilled
+	size_k spilled_k;
+	/// the duplicates of spilled states, to be purged
+	vector<const packed_state*> dropped;
+
+	/// the bit-state table, empty if the states are stored
+	vector<uint64_t> bit_table;
+	/// the number of bits in the table minus 1
+	uint64_t bit_mask;
+	/// the number of bits set in the table
+	ulong bits_set;
+	/// the number of states inserted into the table
+	ulong bitstate_size;
+
+	static const size_k DROPPED;
+	static const packed_state HASHED;
+	static const ushort HASH_FUNCTIONS;
+
+	bool insert(const packed_state& p);
+
+	vector<bool> lookup(const vector<packed_state>& states) const;
+	void drop(const packed_state& p);
+
+	static size_t footprint(const packed_state& p);
+	static bool read(FILE* file, string& bytes);
+	static void write(FILE* file, const string& bytes);
+};
+
+} /* namespace ruba */
+
+#endif /* DS_REACHED_HH_ */
@@ -0,0 +1,123 @@
+/**
+ * summary.cc
+ *
+ * @date  : Oct 18, 2026
+ * @author: TODO
+ */
+
+#include "summary.hh"
+
+namespace ruba {
+
+/**
+ * Default constructor: no thread
+ */
+summary_table::summary_table() :
+		CPDA(nullptr), cache(), lock() {
+}
+
+/**
+ * Constructor
+ * @param CPDA
+ */
+summary_table::summary_table(const concurrent_pushdown_automata& CPDA) :
+		CPDA(&CPDA), cache(CPDA.size()), lock() {
+}
+
+/**
+ * destructor
+ */
+summary_table::~summary_table() {
+}
+
+/**
+ * Return the summary of the procedure of thread tid entered at (q, a),
+ * computing it on the first query
+ * @param tid
+ * @param q
+ * @param a
+ * @return procedure_summary
+ */
+shared_ptr<const procedure_summary> summary_table::get(const size_n tid,
+		const pda_state& q, const pda_alpha& a) {
+	const auto key = (uint64_t(q) << 32) | a;
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		auto ifind = cache[tid].find(key);
+		if (ifind != cache[tid].end())
+			return ifind->second;
+	}
+	/// the summary is computed out of the lock: if two threads compute the
+	/// same summary, they compute the same one
+	const auto& s = compute((*CPDA)[tid], q, a);
+	std::lock_guard<std::mutex> guard(lock);
+	return cache[tid].emplace(key, s).first->second;
+}
+
+/**
+ * @return the number of summaries computed
+ */
+size_t summary_table::size() const {
+	std::lock_guard<std::mutex> guard(lock);
+	size_t n = 0;
+	for (const auto& summaries : cache)
+		n += summaries.size();
+	return n;
+}
+
+/**
+ * Compute the summary of the procedure of PDA entered at (q, a): explore
+ * the configurations of PDA from (q, a) until a is popped. It terminates
+ * as the finite context reachability holds.
+ * @param PDA
+ * @param q
+ * @param a
+ * @return procedure_summary
+ */
+shared_ptr<const procedure_summary> summary_table::compute(
+		const pushdown_automaton& PDA, const pda_state& q,
+		const pda_alpha& a) const {
+	auto s = std::make_shared<procedure_summary>();
+	pda_stack w;
+	w.push(a);
+	/// the configurations explored, where stacks are listed from the top
+	set<pair<pda_state, vector<pda_alpha>>> explored;
+	explored.emplace(q, vector<pda_alpha>(1, a));
+	set<pda_state> exits;
+	deque<pair<pda_state, pda_stack>> worklist;
+	worklist.emplace_back(q, w);
+	while (!worklist.empty()) {
+		const auto c = worklist.front();
+		worklist.pop_front();
+		for (const auto& m : PDA.get_moves(c.first, c.second.top())) {
+			auto _w = c.second;
+			switch (m.op) {
+			case type_stack_operation::PUSH: { /// push operation
+				_w.pop();
+				_w.push(m.below);
+				_w.push(m.top);
+			}
+				break;
+			case type_stack_operation::POP: { /// pop operation
+				_w.pop();
+			}
+				break;
+			default: { /// overwrite operation
+				_w.overwrite(m.top);
+			}
+				break;
+			}
+			if (_w.empty()) {
+				exits.emplace(m.dst);
+			} else if (explored.emplace(m.dst,
+					vector<pda_alpha>(_w.begin(), _w.end())).second) {
+				s->inner.emplace_back(m.dst, _w);
+				worklist.emplace_back(m.dst, _w);
+			}
+		}
+	}
+	s->exits.assign(exits.begin(), exits.end());
+	return s;
+}
+
+} /* namespace ruba */
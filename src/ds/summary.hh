@@ -0,0 +1,55 @@
+/**
+ * summary.hh
+ *
+ * @date  : Oct 18, 2026
+ * @author: TODO
+ */
+
+#ifndef DS_SUMMARY_HH_
+#define DS_SUMMARY_HH_
+
+#include "cpda.hh"
+
+namespace ruba {
+
+/**
+ * The summary of the procedure entered at the shared state q with the
+ * stack symbol a on top: within one context, the thread runs alone, so
+ * what it does until a is popped depends only on (q, a), and not on the
+ * stack below a.
+ */
+struct procedure_summary {
+	/// the configurations (q', x) reached before a is popped, where x is
+	/// the part of the stack above the one below a; (q, a) is left out
+	vector<pair<pda_state, pda_stack>> inner;
+	/// the shared states reached by popping a
+	vector<pda_state> exits;
+};
+
+/**
+ * The procedure summaries of each thread of a CPDS, computed on demand
+ * and cached. It's safe to query from several threads at the same time.
+ */
+class summary_table {
+public:
+	summary_table();
+	summary_table(const concurrent_pushdown_automata& CPDA);
+	~summary_table();
+
+	shared_ptr<const procedure_summary> get(const size_n tid,
+			const pda_state& q, const pda_alpha& a);
+	size_t size() const;
+
+private:
+	const concurrent_pushdown_automata* CPDA;
+	/// the summaries of each thread, keyed by (q, a)
+	vector<unordered_map<uint64_t, shared_ptr<const procedure_summary>>> cache;
+	mutable std::mutex lock;
+
+	shared_ptr<const procedure_summary> compute(const pushdown_automaton& PDA,
+			const pda_state& q, const pda_alpha& a) const;
+};
+
+} /* namespace ruba */
+
+#endif /* DS_SUMMARY_HH_ */
@@ -0,0 +1,253 @@
+/**
+ * symmetry.cc
+ *
+ * @date  : Oct 18, 2026
+ * @author: TODO
+ */
+
+#include "symmetry.hh"
+
+namespace ruba {
+
+/**
+ * Default constructor: no symmetry
+ */
+symmetry::symmetry() :
+		classes(), lo() {
+}
+
+/**
+ * Detect the classes of interchangeable threads
+ * @param CPDA
+ * @param c_I the initial state
+ * @param pop_candidates the symbols that the bounded stacks of the
+ *        generator may uncover, if any
+ */
+symmetry::symmetry(const concurrent_pushdown_automata& CPDA,
+		const explicit_state& c_I,
+		const vector<set<pda_alpha>>& pop_candidates) :
+		classes(), lo(c_I.get_stacks().size(), 0) {
+	const size_n n = c_I.get_stacks().size();
+	if (CPDA.size() < n)
+		return;
+	for (size_n i = 0; i < n; ++i) {
+		if (!CPDA[i].get_alphas().empty())
+			lo[i] = *CPDA[i].get_alphas().begin();
+	}
+
+	/// interchangeability is an equivalence, so each thread is compared
+	/// with the first thread of each existing class only
+	vector<vector<size_n>> candidates;
+	for (size_n i = 0; i < n; ++i) {
+		bool is_found = false;
+		for (auto& c : candidates) {
+			if (is_interchangeable(CPDA, c_I, pop_candidates, c.front(), i)) {
+				c.emplace_back(i);
+				is_found = true;
+				break;
+			}
+		}
+		if (!is_found)
+			candidates.emplace_back(vector<size_n>(1, i));
+	}
+	for (const auto& c : candidates) {
+		if (c.size() > 1)
+			classes.emplace_back(c);
+	}
+}
+
+/**
+ * destructor
+ */
+symmetry::~symmetry() {
+}
+
+/**
+ * Return the canonical representative of c
+ * @param c
+ * @return explicit_state
+ */
+explicit_state symmetry::canonicalize(const explicit_state& c) const {
+	if (classes.empty())
+		return c;
+	stack_vec W;
+	permute(c.get_stacks(), W);
+	return explicit_state(c.get_state(), W);
+}
+
+/**
+ * Return the canonical representative of c. The active thread and the
+ * preempted thread follow their stacks.
+ * @param c
+ * @return explicit_state_tid
+ */
+explicit_state_tid symmetry::canonicalize(const explicit_state_tid& c) const {
+	if (classes.empty())
+		return c;
+	stack_vec W;
+	const auto& pos = permute(c.get_stacks(), W);
+	auto move = [&pos](const id_thread t) {
+		return t < pos.size() ? pos[t] : t;
+	};
+	explicit_state_tid _c(move(c.get_thread_id()), c.get_context_k(),
+			c.get_state(), W);
+	_c.set_preempted(move(c.get_preempted()));
+	_c.set_summarized(c.is_summarized());
+	_c.set_action(c.get_action());
+	_c.set_reached(c.get_reached());
+	return _c;
+}
+
+/**
+ * Return the canonical representative of v: the top symbols of each class
+ * are sorted, compared after the shift. An empty stack comes last.
+ * @param v
+ * @return visible_state
+ */
+visible_state symmetry::canonicalize(const visible_state& v) const {
+	if (classes.empty() || v.get_local().size() != lo.size())
+		return v;
+	auto L = v.get_local();
+	for (const auto& c : classes) {
+		vector<pda_alpha> tops;
+		tops.reserve(c.size());
+		for (const auto i : c) {
+			const auto l = v.get_local()[i];
+			tops.emplace_back(l == alphabet::EPSILON ? l : l - lo[i]);
+		}
+		std::sort(tops.begin(), tops.end());
+		for (size_t p = 0; p < c.size(); ++p) {
+			const auto l = tops[p];
+			L[c[p]] = l == alphabet::EPSILON ? l : l + lo[c[p]];
+		}
+	}
+	return visible_state(v.get_state(), L);
+}
+
+/**
+ * Determine whether threads i and j are interchangeable
+ * @param CPDA
+ * @param c_I
+ * @param pop_candidates
+ * @param i
+ * @param j
+ * @return bool
+ */
+bool symmetry::is_interchangeable(const concurrent_pushdown_automata& CPDA,
+		const explicit_state& c_I, const vector<set<pda_alpha>>& pop_candidates,
+		const size_n i, const size_n j) const {
+	const auto& P1 = CPDA[i];
+	const auto& P2 = CPDA[j];
+	if (P1.get_alphas().size() != P2.get_alphas().size()
+			|| P1.get_actions().size() != P2.get_actions().size())
+		return false;
+	/// step 1: the initial stacks
+	if (compare(c_I.get_stacks()[i], i, c_I.get_stacks()[j], j) != 0)
+		return false;
+	/// step 2: the symbols that the generator may uncover
+	if (i < pop_candidates.size() || j < pop_candidates.size()) {
+		if (i >= pop_candidates.size() || j >= pop_candidates.size()
+				|| pop_candidates[i].size() != pop_candidates[j].size())
+			return false;
+		auto ia = pop_candidates[i].begin();
+		for (const auto b : pop_candidates[j]) {
+			if (*ia++ - lo[i] != b - lo[j])
+				return false;
+		}
+	}
+	/// step 3: the actions
+	return normalize(P1, lo[i]) == normalize(P2, lo[j]);
+}
+
+/**
+ * Normalize the actions of PDA, with the stack symbols shifted by -lo
+ * @param PDA
+ * @param lo
+ * @return the set of normalized actions
+ */
+set<vector<uint>> symmetry::normalize(const pushdown_automaton& PDA,
+		const pda_alpha lo) const {
+	auto shift = [lo](const pda_alpha l) {
+		return l == alphabet::EPSILON ? l : l - lo;
+	};
+	set<vector<uint>> actions;
+	for (const auto& r : PDA.get_actions()) {
+		const auto dst = r.get_dst();
+		vector<uint> a { r.get_src().get_state(), shift(
+				r.get_src().get_alpha()), uint(r.get_oper_type()),
+				dst.get_state() };
+		for (const auto l : dst.get_stack())
+			a.emplace_back(shift(l));
+		actions.emplace(a);
+	}
+	return actions;
+}
+
+/**
+ * Compare the stack w1 of thread i with the stack w2 of thread j, after
+ * the shift: first by their sizes, then from top to bottom.
+ * @param w1
+ * @param i
+ * @param w2
+ * @param j
+ * @return int -1, 0 or 1
+ */
+int symmetry::compare(const pda_stack& w1, const size_n i,
+		const pda_stack& w2, const size_n j) const {
+	if (w1.size() != w2.size())
+		return w1.size() < w2.size() ? -1 : 1;
+	auto iw2 = w2.begin();
+	for (const auto a : w1) {
+		const auto l1 = a - lo[i], l2 = *iw2++ - lo[j];
+		if (l1 != l2)
+			return l1 < l2 ? -1 : 1;
+	}
+	return 0;
+}
+
+/**
+ * Move the stack w of thread from to thread to
+ * @param w
+ * @param from
+ * @param to
+ * @return pda_stack
+ */
+pda_stack symmetry::shift(const pda_stack& w, const size_n from,
+		const size_n to) const {
+	if (lo[from] == lo[to])
+		return w;
+	const vector<pda_alpha> symbols(w.begin(), w.end());
+	pda_stack _w;
+	for (auto is = symbols.rbegin(); is != symbols.rend(); ++is)
+		_w.push(*is - lo[from] + lo[to]);
+	return _w;
+}
+
+/**
+ * Sort the stacks W of each class into _W
+ * @param W
+ * @param _W
+ * @return the new position of each thread
+ */
+vector<size_n> symmetry::permute(const stack_vec& W, stack_vec& _W) const {
+	_W = W;
+	vector<size_n> pos(W.size());
+	for (size_n i = 0; i < W.size(); ++i)
+		pos[i] = i;
+	for (const auto& c : classes) {
+		auto order = c;
+		std::stable_sort(order.begin(), order.end(),
+				[&](const size_n i, const size_n j) {
+					return compare(W[i], i, W[j], j) < 0;
+				});
+		for (size_t p = 0; p < c.size(); ++p) {
+			if (order[p] == c[p])
+				continue;
+			_W[c[p]] = shift(W[order[p]], order[p], c[p]);
+			pos[order[p]] = c[p];
+		}
+	}
+	return pos;
+}
+
+} /* namespace ruba */
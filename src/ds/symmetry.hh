@@ -0,0 +1,70 @@
+/**
+ * symmetry.hh
+ *
+ * @date  : Oct 18, 2026
+ * @author: TODO
+ */
+
+#ifndef DS_SYMMETRY_HH_
+#define DS_SYMMETRY_HH_
+
+#include "cpda.hh"
+
+namespace ruba {
+
+/**
+ * Symmetry of a CPDS: threads i and j are interchangeable if their PDAs
+ * are identical up to a shift of the stack symbols, lo_j - lo_i, and so
+ * are their initial stacks. Swapping two interchangeable threads then maps
+ * the reachable states onto themselves, so it suffices to explore one
+ * canonical representative of each class of permuted states.
+ *
+ * The canonical representative sorts the stacks of each class of
+ * interchangeable threads, compared after the shift: the smallest stack
+ * goes to the thread with the smallest index, and so on.
+ */
+class symmetry {
+public:
+	symmetry();
+	symmetry(const concurrent_pushdown_automata& CPDA,
+			const explicit_state& c_I,
+			const vector<set<pda_alpha>>& pop_candidates = { });
+	~symmetry();
+
+	/**
+	 * @return true if no two threads are interchangeable
+	 */
+	bool empty() const {
+		return classes.empty();
+	}
+
+	const vector<vector<size_n>>& get_classes() const {
+		return classes;
+	}
+
+	explicit_state canonicalize(const explicit_state& c) const;
+	explicit_state_tid canonicalize(const explicit_state_tid& c) const;
+	visible_state canonicalize(const visible_state& v) const;
+
+private:
+	/// the classes of interchangeable threads, each of size > 1
+	vector<vector<size_n>> classes;
+	/// the smallest stack symbol of each thread
+	vector<pda_alpha> lo;
+
+	bool is_interchangeable(const concurrent_pushdown_automata& CPDA,
+			const explicit_state& c_I,
+			const vector<set<pda_alpha>>& pop_candidates, const size_n i,
+			const size_n j) const;
+	set<vector<uint>> normalize(const pushdown_automaton& PDA,
+			const pda_alpha lo) const;
+	int compare(const pda_stack& w1, const size_n i, const pda_stack& w2,
+			const size_n j) const;
+	pda_stack shift(const pda_stack& w, const size_n from,
+			const size_n to) const;
+	vector<size_n> permute(const stack_vec& W, stack_vec& _W) const;
+};
+
+} /* namespace ruba */
+
+#endif /* DS_SYMMETRY_HH_ */
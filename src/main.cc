@@ -105,11 +105,60 @@ int main(const int argc, const char * const * const argv) {
 				cmd_line::get_opt_index(opt_type::CON), "--stack-bound-for-z");
 		flags::OPT_Z_APPROXIMATION_BOUND =
 				z_bound.size() == 0 ? 1 : std::stoul(z_bound);
+		const string& threads = cmd.arg_value(
+				cmd_line::get_opt_index(opt_type::CON), "--threads");
+		flags::OPT_NUM_THREADS =
+				threads.size() == 0 ? 1 : std::stoul(threads);
+		if (flags::OPT_NUM_THREADS == 0)
+			throw cuba_runtime_error("The number of threads must be > 0");
 
 		size_k k = k_bound.size() == 0 ? 0 : std::stoul(k_bound);
 
 		const bool is_explicit = cmd.arg_bool(
 				cmd_line::get_opt_index(opt_type::CON), "--explicit");
+		flags::OPT_POR = cmd.arg_bool(cmd_line::get_opt_index(opt_type::CON),
+				"--por");
+		flags::OPT_SYMMETRY = cmd.arg_bool(
+				cmd_line::get_opt_index(opt_type::CON), "--symmetry");
+		flags::OPT_SUMMARY = cmd.arg_bool(
+				cmd_line::get_opt_index(opt_type::CON), "--summary");
+		const string& memory_limit = cmd.arg_value(
+				cmd_line::get_opt_index(opt_type::CON), "--memory-limit");
+		flags::OPT_MEMORY_LIMIT =
+				memory_limit.size() == 0 ? 0 : std::stoul(memory_limit);
+		const string& bitstate = cmd.arg_value(
+				cmd_line::get_opt_index(opt_type::CON), "--bitstate");
+		flags::OPT_BITSTATE = bitstate.size() == 0 ? 0 : std::stoul(bitstate);
+		if (flags::OPT_BITSTATE > 40)
+			throw cuba_runtime_error("The bit-state table must be <= 2^40 bits");
+		const string& search = cmd.arg_value(
+				cmd_line::get_opt_index(opt_type::CON), "--search");
+		if (search != "bfs" && search != "best-first")
+			throw cuba_runtime_error("The search strategy must be bfs or best-first");
+		flags::OPT_BEST_FIRST = search == "best-first";
+		if (flags::OPT_BEST_FIRST && final == "X")
+			throw cuba_runtime_error("Best-first search requires a target state!");
+		flags::OPT_WITNESS = cmd.arg_value(
+				cmd_line::get_opt_index(opt_type::CON), "--witness");
+		if (!flags::OPT_WITNESS.empty()) {
+			if (flags::OPT_WITNESS != "text" && flags::OPT_WITNESS != "json")
+				throw cuba_runtime_error("The witness must be printed as text or json");
+			if (flags::OPT_BITSTATE > 0 || flags::OPT_MEMORY_LIMIT > 0)
+				throw cuba_runtime_error(
+						"A witness needs the reached states kept in memory");
+			if (flags::OPT_SYMMETRY)
+				throw cuba_runtime_error(
+						"A witness is not available under symmetry reduction");
+		}
+		flags::OPT_CHECKPOINT = cmd.arg_value(
+				cmd_line::get_opt_index(opt_type::CON), "--checkpoint");
+		flags::OPT_RESUME = cmd.arg_bool(
+				cmd_line::get_opt_index(opt_type::CON), "--resume");
+		if (flags::OPT_RESUME && flags::OPT_CHECKPOINT.empty())
+			throw cuba_runtime_error("Please specify the checkpoint to resume!");
+		if (!flags::OPT_CHECKPOINT.empty() && flags::OPT_BEST_FIRST)
+			throw cuba_runtime_error(
+					"Checkpoints are only taken by the breadth-first search");
 
 		/// Other Options
 		flags::OPT_PRINT_CMD = cmd.arg_bool(
@@ -121,6 +170,12 @@ int main(const int argc, const char * const * const argv) {
 		flags::OPT_FILE_DUMP = cmd.arg_bool(
 				cmd_line::get_opt_index(opt_type::OTHER), "--file-dump");
 
+		const string stats_format = cmd.arg_value(
+				cmd_line::get_opt_index(opt_type::OTHER), "--stats");
+		if (!stats_format.empty() && stats_format != "json")
+			throw cuba_runtime_error("The statistics must be printed as json");
+		flags::OPT_STATS = !stats_format.empty();
+
 		if (mode == "O") {
 			cout << "overapproximation mode......\n";
 			cout << filename << " " << initl << "\n";
@@ -152,6 +207,8 @@ int main(const int argc, const char * const * const argv) {
 					scuba.context_unbounded_analysis(k);
 				}
 			}
+			if (flags::OPT_STATS)
+				stats::dump_json(cout);
 		}
 
 	} catch (const cmd::cmd_runtime_error& e) {
@@ -0,0 +1,34 @@
+/**
+ * binary.cc
+ *
+ * @date  : Oct 18, 2026
+ * @author: TODO
+ */
+
+#include "binary.hh"
+
+namespace ruba {
+
+/**
+ * Write the string s to file, prefixed by its length
+ * @param file
+ * @param s
+ */
+void binary::write_string(FILE* file, const string& s) {
+	write(file, uint32_t(s.size()));
+	write(file, s.data(), s.size());
+}
+
+/**
+ * Read a length-prefixed string from file
+ * @param file
+ * @return string
+ */
+string binary::read_string(FILE* file) {
+	string s(read<uint32_t>(file), '\0');
+	if (!s.empty())
+		read(file, &s[0], s.size());
+	return s;
+}
+
+} /* namespace ruba */
@@ -0,0 +1,71 @@
+/**
+ * binary.hh
+ *
+ * @date  : Oct 18, 2026
+ * @author: TODO
+ */
+
+#ifndef UTILS_BINARY_HH_
+#define UTILS_BINARY_HH_
+
+#include "heads.hh"
+
+namespace ruba {
+
+/**
+ * The binary I/O of checkpoints: integers are written as they are laid
+ * out in memory, so a file is read back on the same kind of machine only;
+ * strings are prefixed by their lengths.
+ */
+class binary {
+public:
+	/**
+	 * Write n values of a trivially copyable type T to file
+	 * @param file
+	 * @param v
+	 * @param n
+	 */
+	template<typename T> static void write(FILE* file, const T* v,
+			const size_t n) {
+		if (n > 0 && std::fwrite(v, sizeof(T), n, file) != n)
+			throw cuba_runtime_error("Cannot write to the checkpoint!");
+	}
+
+	/**
+	 * Read n values of a trivially copyable type T from file
+	 * @param file
+	 * @param v
+	 * @param n
+	 */
+	template<typename T> static void read(FILE* file, T* v, const size_t n) {
+		if (n > 0 && std::fread(v, sizeof(T), n, file) != n)
+			throw cuba_runtime_error("Corrupted checkpoint!");
+	}
+
+	/**
+	 * Write the value v to file
+	 * @param file
+	 * @param v
+	 */
+	template<typename T> static void write(FILE* file, const T& v) {
+		write(file, &v, 1);
+	}
+
+	/**
+	 * Read a value of type T from file
+	 * @param file
+	 * @return T
+	 */
+	template<typename T> static T read(FILE* file) {
+		T v;
+		read(file, &v, 1);
+		return v;
+	}
+
+	static void write_string(FILE* file, const string& s);
+	static string read_string(FILE* file);
+};
+
+} /* namespace ruba */
+
+#endif /* UTILS_BINARY_HH_ */
@@ -351,8 +351,36 @@ void cmd_line::create_argument_list() {
 			""); /// row 4
 	this->add_option(get_opt_index(opt_type::CON), "-z", "--stack-bound-for-z",
 			string("stack bound for Z approximation (default = 1): Value must be > 0").c_str(), "");
+	this->add_option(get_opt_index(opt_type::CON), "-t", "--threads",
+			string("number of threads for the exploration (default = 1)").c_str(), "");
 	this->add_switch(get_opt_index(opt_type::CON), "-x", "--explicit",
 			"run the explicit exploration assuming finite resource reachability holds");
+	this->add_switch(get_opt_index(opt_type::CON), "-r", "--por",
+			"skip redundant context switches in the explicit exploration");
+	this->add_switch(get_opt_index(opt_type::CON), "-y", "--symmetry",
+			"explore one permutation of interchangeable threads in the explicit exploration");
+	this->add_switch(get_opt_index(opt_type::CON), "-u", "--summary",
+			"apply procedure summaries within a context in the explicit exploration");
+	this->add_option(get_opt_index(opt_type::CON), "-M", "--memory-limit",
+			string("memory limit in MB for the states reached in the explicit exploration,\n")
+			.append(string(26, ' ')).append(
+					"spilling them to disk beyond it (default = 0: unlimited)").c_str(), "");
+	this->add_option(get_opt_index(opt_type::CON), "-b", "--bitstate",
+			string("hash the states reached in the explicit exploration into a table of\n")
+			.append(string(26, ' ')).append(
+					"2^b bits, which may omit states (default = 0: store them all)").c_str(), "");
+	this->add_option(get_opt_index(opt_type::CON), "-e", "--search",
+			string("the search strategy of the explicit exploration: bfs or best-first,\n")
+			.append(string(26, ' ')).append(
+					"which expands the states closest to the target first").c_str(), "bfs");
+	this->add_option(get_opt_index(opt_type::CON), "-o", "--witness",
+			string("print a path to the target found by the explicit exploration,\n")
+			.append(string(26, ' ')).append(
+					"as text or json (default = none)").c_str(), "");
+	this->add_option(get_opt_index(opt_type::CON), "-C", "--checkpoint",
+			"save the explicit exploration to a directory after each context", "");
+	this->add_switch(get_opt_index(opt_type::CON), "-R", "--resume",
+			"resume the explicit exploration from its checkpoint");
 
 	/// other options
 	this->add_switch(get_opt_index(opt_type::OTHER), "-c", "--cmd-line",
@@ -361,6 +389,9 @@ void cmd_line::create_argument_list() {
 			"print all output, including states and visible states, in each round");
 	this->add_switch(get_opt_index(opt_type::OTHER), "-d", "--file-dump",
 			"dump reachable global states and visible states, if applicable, to files");
+	this->add_option(get_opt_index(opt_type::OTHER), "-S", "--stats",
+			"print the time and counters of each phase and level as json (default = none)",
+			"");
 	this->add_switch(get_opt_index(opt_type::OTHER), SHORT_VERSION_OPT,
 			LONG_VERSION_OPT, "show version information and exit");
 }
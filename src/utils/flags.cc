@@ -27,6 +27,17 @@ bool flags::OPT_SEQ_ATM = false;
 bool flags::OPT_NESTED_MATCH = false;
 string flags::OPT_MATCHING_FILE = "X";
 size_t flags::OPT_Z_APPROXIMATION_BOUND = 1;
+size_t flags::OPT_NUM_THREADS = 1;
+bool flags::OPT_POR = false;
+bool flags::OPT_SYMMETRY = false;
+size_t flags::OPT_MEMORY_LIMIT = 0;
+ushort flags::OPT_BITSTATE = 0;
+bool flags::OPT_SUMMARY = false;
+bool flags::OPT_BEST_FIRST = false;
+string flags::OPT_WITNESS = "";
+string flags::OPT_CHECKPOINT = "";
+bool flags::OPT_RESUME = false;
+bool flags::OPT_STATS = false;
 
 const string flags::COMMENT = "#";
 
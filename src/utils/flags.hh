@@ -28,6 +28,17 @@ public:
 	static bool OPT_NESTED_MATCH;
 	static string OPT_MATCHING_FILE;
 	static size_t OPT_Z_APPROXIMATION_BOUND;
+	static size_t OPT_NUM_THREADS;
+	static bool OPT_POR;
+	static bool OPT_SYMMETRY;
+	static size_t OPT_MEMORY_LIMIT;
+	static ushort OPT_BITSTATE;
+	static bool OPT_SUMMARY;
+	static bool OPT_BEST_FIRST;
+	static string OPT_WITNESS;
+	static string OPT_CHECKPOINT;
+	static bool OPT_RESUME;
+	static bool OPT_STATS;
 
 	static const string COMMENT;
 
@@ -9,6 +9,7 @@
 #define HEADS_HH_
 #include <cstdio>
 #include <cstdlib>
+#include <cmath>
 #include <cassert>
 #include <ctime>
 
@@ -33,6 +34,14 @@
 #include <iterator>
 #include <algorithm>
 #include <memory>
+#include <limits>
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+#include <exception>
 
 #include "excep.hh"
 #include "log.hh"
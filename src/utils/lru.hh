@@ -0,0 +1,111 @@
+/**
+ * lru.hh
+ *
+ * @date  : Oct 18, 2026
+ * @author: TODO
+ */
+
+#ifndef UTILS_LRU_HH_
+#define UTILS_LRU_HH_
+
+#include "heads.hh"
+
+namespace ruba {
+
+/**
+ * A cache of a bounded number of entries: once it's full, inserting an
+ * entry evicts the least recently used one. It counts the hits and the
+ * misses of the lookups.
+ */
+template<typename K, typename V, typename H = std::hash<K>>
+class lru_cache {
+public:
+	lru_cache(const size_t capacity);
+	~lru_cache();
+
+	const V* find(const K& key);
+	void insert(const K& key, const V& value);
+
+	ulong get_hits() const {
+		return hits;
+	}
+
+	ulong get_misses() const {
+		return misses;
+	}
+
+	size_t size() const {
+		return entries.size();
+	}
+
+private:
+	/// the maximum number of entries
+	size_t capacity;
+	/// the entries, from the most recently used to the least
+	list<pair<K, V>> entries;
+	/// the position of each entry in entries
+	unordered_map<K, typename list<pair<K, V>>::iterator, H> index;
+	ulong hits;
+	ulong misses;
+};
+
+/**
+ * Constructor
+ * @param capacity the maximum number of entries, 0 to cache nothing
+ */
+template<typename K, typename V, typename H>
+lru_cache<K, V, H>::lru_cache(const size_t capacity) :
+		capacity(capacity), entries(), index(), hits(0), misses(0) {
+}
+
+/**
+ * destructor
+ */
+template<typename K, typename V, typename H>
+lru_cache<K, V, H>::~lru_cache() {
+}
+
+/**
+ * Look up key. The entry found becomes the most recently used.
+ * @param key
+ * @return the value of key, nullptr if it's not cached
+ */
+template<typename K, typename V, typename H>
+const V* lru_cache<K, V, H>::find(const K& key) {
+	auto ifind = index.find(key);
+	if (ifind == index.end()) {
+		++misses;
+		return nullptr;
+	}
+	++hits;
+	entries.splice(entries.begin(), entries, ifind->second);
+	return &ifind->second->second;
+}
+
+/**
+ * Insert the value of key, evicting the least recently used entry if the
+ * cache is full
+ * @param key
+ * @param value
+ */
+template<typename K, typename V, typename H>
+void lru_cache<K, V, H>::insert(const K& key, const V& value) {
+	if (capacity == 0)
+		return;
+	auto ifind = index.find(key);
+	if (ifind != index.end()) {
+		ifind->second->second = value;
+		entries.splice(entries.begin(), entries, ifind->second);
+		return;
+	}
+	if (entries.size() == capacity) {
+		index.erase(entries.back().first);
+		entries.pop_back();
+	}
+	entries.emplace_front(key, value);
+	index.emplace(key, entries.begin());
+}
+
+} /* namespace ruba */
+
+#endif /* UTILS_LRU_HH_ */
@@ -0,0 +1,168 @@
+/**
+ * parallel.cc
+ *
+ * @date  : Oct 18, 2026
+ * @author: TODO
+ */
+
+#include "parallel.hh"
+
+namespace ruba {
+
+/**
+ * The worker threads of the parallel loops. A loop is run by the calling
+ * thread and all the workers; the workers sleep between loops.
+ */
+class parallel::pool {
+public:
+	pool(const size_t n_workers);
+	~pool();
+	void run(const size_t n, const size_t chunk,
+			const std::function<void(const size_t)>& f);
+private:
+	vector<std::thread> workers;
+	std::mutex mutex;
+	/// wake: a loop is started or the pool stops; done: a worker is done
+	std::condition_variable wake, done;
+	/// the number of loops started, so that a worker runs each loop once
+	ulong loops;
+	/// the workers running the current loop
+	size_t busy;
+	bool stopping;
+
+	/// the current loop
+	size_t n;
+	size_t chunk;
+	const std::function<void(const size_t)>* f;
+	std::atomic<size_t> next;
+	std::exception_ptr error;
+
+	void serve();
+	void work();
+};
+
+/// whether the thread runs a loop: a loop within a loop runs sequentially
+static thread_local bool in_loop = false;
+
+/**
+ * Start n_workers worker threads
+ * @param n_workers
+ */
+parallel::pool::pool(const size_t n_workers) :
+		workers(), mutex(), wake(), done(), loops(0), busy(0), stopping(
+				false), n(0), chunk(1), f(nullptr), next(0), error(nullptr) {
+	workers.reserve(n_workers);
+	for (size_t t = 0; t < n_workers; ++t)
+		workers.emplace_back(&pool::serve, this);
+}
+
+/**
+ * Stop the worker threads
+ */
+parallel::pool::~pool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (auto& w : workers)
+		w.join();
+}
+
+/**
+ * Run f(0), ..., f(n-1), in chunks of chunk indices, with the calling
+ * thread and all workers. The first exception thrown by f is rethrown
+ * once all workers are done.
+ * @param n
+ * @param chunk
+ * @param f
+ */
+void parallel::pool::run(const size_t n, const size_t chunk,
+		const std::function<void(const size_t)>& f) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		this->n = n;
+		this->chunk = chunk;
+		this->f = &f;
+		next = 0;
+		error = nullptr;
+		busy = workers.size();
+		++loops;
+	}
+	wake.notify_all();
+	in_loop = true;
+	work();
+	in_loop = false;
+
+	std::unique_lock<std::mutex> lock(mutex);
+	done.wait(lock, [this]() {return busy == 0;});
+	this->f = nullptr;
+	if (error != nullptr)
+		std::rethrow_exception(error);
+}
+
+/**
+ * The procedure of a worker thread: run each loop started until the pool
+ * stops
+ */
+void parallel::pool::serve() {
+	in_loop = true;
+	ulong done_loops = 0;
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		wake.wait(lock, [&]() {return stopping || loops != done_loops;});
+		if (stopping)
+			return;
+		done_loops = loops;
+		lock.unlock();
+		work();
+		lock.lock();
+		if (--busy == 0)
+			done.notify_one();
+	}
+}
+
+/**
+ * Take chunks of indices of the current loop until none is left
+ */
+void parallel::pool::work() {
+	try {
+		for (size_t i = next.fetch_add(chunk); i < n;
+				i = next.fetch_add(chunk)) {
+			const auto end = std::min(n, i + chunk);
+			for (; i < end; ++i)
+				(*f)(i);
+		}
+	} catch (...) {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (error == nullptr)
+			error = std::current_exception();
+		next = n; /// stop the other workers
+	}
+}
+
+/**
+ * Run f(0), ..., f(n-1) with up to n_threads threads. It runs in the
+ * calling thread if n_threads <= 1. The first exception thrown by f is
+ * rethrown once all workers have stopped. The pool is started with
+ * n_threads - 1 workers by the first loop run in parallel.
+ * @param n
+ * @param n_threads
+ * @param f
+ */
+void parallel::for_each(const size_t n, const size_t n_threads,
+		const std::function<void(const size_t)>& f) {
+	if (n_threads <= 1 || n <= 1 || in_loop) {
+		for (size_t i = 0; i < n; ++i)
+			f(i);
+		return;
+	}
+
+	static pool workers(n_threads - 1);
+	/// small chunks keep the threads balanced when the cost of f varies
+	const size_t chunk = std::max<size_t>(1,
+			n / (std::min(n_threads, n) * 8));
+	workers.run(n, chunk, f);
+}
+
+} /* namespace ruba */
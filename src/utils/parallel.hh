@@ -0,0 +1,36 @@
+/**
+ * parallel.hh
+ *
+ * @date  : Oct 18, 2026
+ * @author: TODO
+ */
+
+#ifndef UTILS_PARALLEL_HH_
+#define UTILS_PARALLEL_HH_
+
+#include "heads.hh"
+
+namespace ruba {
+
+/**
+ * A minimal parallel loop: it runs f(0), ..., f(n-1) on a number of
+ * worker threads. The workers take chunks of indices from a shared
+ * counter, so a worker that finishes early keeps taking the work left
+ * by the others. f must not write to state shared between indices.
+ *
+ * The worker threads are started by the first loop, and wait for the
+ * next loops until the program exits: a loop, e.g., over a block of a
+ * frontier, only wakes them up. A loop run within a loop runs in the
+ * calling thread.
+ */
+class parallel {
+public:
+	static void for_each(const size_t n, const size_t n_threads,
+			const std::function<void(const size_t)>& f);
+private:
+	class pool;
+};
+
+} /* namespace ruba */
+
+#endif /* UTILS_PARALLEL_HH_ */
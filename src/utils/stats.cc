@@ -0,0 +1,180 @@
+/**
+ * stats.cc
+ *
+ * @date  : Oct 18, 2026
+ * @author: TODO
+ */
+
+#include <sys/resource.h>
+
+#include "stats.hh"
+
+namespace ruba {
+
+string stats::engine = "";
+double stats::generator_time = 0;
+double stats::fcr_time = 0;
+vector<stats::level_stats> stats::levels;
+const std::chrono::steady_clock::time_point stats::started =
+		std::chrono::steady_clock::now();
+
+/**
+ * Constructor: start timing phase p of level
+ * @param p
+ * @param level
+ */
+stats::timer::timer(const phase p, const uint level) :
+		p(p), level(level), start(std::chrono::steady_clock::now()) {
+}
+
+/**
+ * Destructor: stop timing
+ */
+stats::timer::~timer() {
+	const std::chrono::duration<double> elapsed =
+			std::chrono::steady_clock::now() - start;
+	add_time(p, level, elapsed.count());
+}
+
+/**
+ * @param engine the name of the engine running the analysis
+ */
+void stats::set_engine(const string& engine) {
+	stats::engine = engine;
+}
+
+/**
+ * Add wall time to phase p of level
+ * @param p
+ * @param level ignored for the phases run once
+ * @param seconds
+ */
+void stats::add_time(const phase p, const uint level, const double seconds) {
+	switch (p) {
+	case phase::GENERATOR:
+		generator_time += seconds;
+		break;
+	case phase::FCR:
+		fcr_time += seconds;
+		break;
+	case phase::EXPANSION:
+		get_level(level).expansion += seconds;
+		break;
+	case phase::TOP_MAPPING:
+		get_level(level).top_mapping += seconds;
+		break;
+	default:
+		get_level(level).convergence += seconds;
+		break;
+	}
+}
+
+/**
+ * Add to the counters of level: the states generated, the ones kept as
+ * new, and the image computations
+ * @param level
+ * @param generated
+ * @param kept
+ * @param image_calls
+ */
+void stats::count(const uint level, const ulong generated, const ulong kept,
+		const ulong image_calls) {
+	auto& l = get_level(level);
+	l.generated += generated;
+	l.kept += kept;
+	l.image_calls += image_calls;
+}
+
+/**
+ * Add to the lookups of level in a cache of images
+ * @param level
+ * @param hits
+ * @param misses
+ */
+void stats::count_cache(const uint level, const ulong hits,
+		const ulong misses) {
+	auto& l = get_level(level);
+	l.cache_hits += hits;
+	l.cache_misses += misses;
+}
+
+/**
+ * Add to the states of the automata minimized in level, before and after
+ * the minimization
+ * @param level
+ * @param from
+ * @param to
+ */
+void stats::count_minimized(const uint level, const ulong from,
+		const ulong to) {
+	auto& l = get_level(level);
+	l.minimized_from += from;
+	l.minimized_to += to;
+}
+
+/**
+ * Set the size of the frontier left by level, i.e., of the states to be
+ * explored by the next level
+ * @param level
+ * @param frontier
+ */
+void stats::set_frontier(const uint level, const ulong frontier) {
+	get_level(level).frontier = frontier;
+}
+
+/**
+ * Print the telemetry as one json object
+ * @param os
+ */
+void stats::dump_json(ostream& os) {
+	const std::chrono::duration<double> total =
+			std::chrono::steady_clock::now() - started;
+	os << "{\"engine\": \"" << engine << "\", \"wall_time\": {\"generator\": "
+			<< generator_time << ", \"fcr\": " << fcr_time << ", \"total\": "
+			<< total.count() << "}, \"levels\": [";
+	for (size_t k = 0; k < levels.size(); ++k) {
+		const auto& l = levels[k];
+		os << (k > 0 ? ", " : "") << "{\"level\": " << k
+				<< ", \"wall_time\": {\"expansion\": " << l.expansion
+				<< ", \"top_mapping\": " << l.top_mapping
+				<< ", \"convergence\": " << l.convergence
+				<< "}, \"generated\": " << l.generated << ", \"kept\": "
+				<< l.kept << ", \"duplicate_rate\": "
+				<< (l.generated == 0 ? 0 : 1 - double(l.kept) / l.generated)
+				<< ", \"frontier\": " << l.frontier << ", \"image_calls\": "
+				<< l.image_calls << ", \"cache_hits\": " << l.cache_hits
+				<< ", \"cache_misses\": " << l.cache_misses
+				<< ", \"minimized_states\": {\"before\": " << l.minimized_from
+				<< ", \"after\": " << l.minimized_to << "}"
+				<< ", \"max_rss_kb\": " << l.max_rss_kb
+				<< "}";
+	}
+	os << "]}" << endl;
+}
+
+/**
+ * Return the counters of level, added if needed. The high-water mark of
+ * the resident memory is updated on each access.
+ * @param level
+ * @return level_stats
+ */
+stats::level_stats& stats::get_level(const uint level) {
+	while (level >= levels.size())
+		levels.emplace_back(
+				level_stats { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 });
+	auto& l = levels[level];
+	l.max_rss_kb = get_max_rss_kb();
+	return l;
+}
+
+/**
+ * @return the high-water mark of the resident memory in KB
+ */
+long stats::get_max_rss_kb() {
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+	return usage.ru_maxrss;
+}
+
+} /* namespace ruba */
@@ -0,0 +1,82 @@
+/**
+ * stats.hh
+ *
+ * @date  : Oct 18, 2026
+ * @author: TODO
+ */
+
+#ifndef UTILS_STATS_HH_
+#define UTILS_STATS_HH_
+
+#include "heads.hh"
+
+namespace ruba {
+
+/**
+ * The telemetry of an analysis, in the same schema for all engines: the
+ * wall time of each phase, and the counters of each level, i.e., of each
+ * context or write round. The phases GENERATOR and FCR are run once, the
+ * others at each level. It's fed by the thread running the analysis.
+ */
+class stats {
+public:
+	enum class phase {
+		GENERATOR, FCR, EXPANSION, TOP_MAPPING, CONVERGENCE
+	};
+
+	/**
+	 * A timer adding the wall time from its construction to its
+	 * destruction to a phase of a level
+	 */
+	class timer {
+	public:
+		timer(const phase p, const uint level = 0);
+		~timer();
+
+	private:
+		phase p;
+		uint level;
+		std::chrono::steady_clock::time_point start;
+	};
+
+	static void set_engine(const string& engine);
+	static void add_time(const phase p, const uint level, const double seconds);
+	static void count(const uint level, const ulong generated,
+			const ulong kept, const ulong image_calls);
+	static void count_cache(const uint level, const ulong hits,
+			const ulong misses);
+	static void count_minimized(const uint level, const ulong from,
+			const ulong to);
+	static void set_frontier(const uint level, const ulong frontier);
+	static void dump_json(ostream& os);
+
+private:
+	/// the counters of a level
+	struct level_stats {
+		double expansion;
+		double top_mapping;
+		double convergence;
+		ulong generated;
+		ulong kept;
+		ulong frontier;
+		ulong image_calls;
+		ulong cache_hits;
+		ulong cache_misses;
+		ulong minimized_from;
+		ulong minimized_to;
+		long max_rss_kb;
+	};
+
+	static string engine;
+	static double generator_time;
+	static double fcr_time;
+	static vector<level_stats> levels;
+	static const std::chrono::steady_clock::time_point started;
+
+	static level_stats& get_level(const uint level);
+	static long get_max_rss_kb();
+};
+
+} /* namespace ruba */
+
+#endif /* UTILS_STATS_HH_ */
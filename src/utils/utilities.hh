@@ -27,6 +27,9 @@ public:
 	static string widthify(const T& x, const ushort& width = 0,
 			const alignment& c = alignment::CENTERED, const char& fill = ' ');
 
+	template<typename T>
+	static void hash_combine(size_t& seed, const T& v);
+
 private:
 
 };
@@ -68,6 +71,17 @@ int algs::compare(const vector<T>& v1, const vector<T>& v2) {
 	return 0;
 }
 
+/**
+ * mix the hash value of v into seed. This follows boost::hash_combine.
+ *
+ * @param seed
+ * @param v
+ */
+template<typename T>
+void algs::hash_combine(size_t& seed, const T& v) {
+	seed ^= std::hash<T>()(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
 template<class T>
 string algs::widthify(const T& x, const ushort& width, const alignment& c,
 		const char& fill) {
@@ -17,8 +17,24 @@ namespace wuba {
  */
 explicit_wuba::explicit_wuba(const string& initl, const string& final,
 		const string& filename) :
-		base_wuba(initl, final, filename) {
-
+		base_wuba(initl, final, filename), sym() {
+	stats::set_engine("explicit_wuba");
+	/// states, visible states and generators are all replaced by their
+	/// canonical representatives under symmetry
+	if (flags::OPT_SYMMETRY) {
+		sym = symmetry(CPDA, initl_c);
+		if (!sym.empty()) {
+			auto _generators = generators;
+			for (auto& states : generators)
+				states.clear();
+			for (const auto& states : _generators) {
+				for (const auto& s : states) {
+					const auto& _s = sym.canonicalize(s);
+					generators[_s.get_state()].emplace(_s);
+				}
+			}
+		}
+	}
 }
 
 /**
@@ -50,14 +66,12 @@ bool explicit_wuba::k_bounded_reachability(const size_k k_bound,
 	deque<explicit_state> currRound;
 	currRound.emplace_back(c_I);
 	size_k k = 0;
-	/// <global_R>: the sequences of reachable global configurations. It's
-	/// a 2-D vector where the row represents the round w.r.t. the resource
-	/// while the column represents the shared state.
-	vector<vector<deque<explicit_state>>> global_R;
-	global_R.reserve(k_bound + 1);
-	global_R.emplace_back(
-			vector<deque<explicit_state>>(thread_visible_state::S));
-	global_R[k][c_I.get_state()].emplace_back(c_I);
+	/// <global_R>: the sequences of reachable global configurations. Its
+	/// levels represent the rounds w.r.t. the resource, and are split by
+	/// the shared state. The completed rounds are spilled to disk if the
+	/// memory limit is exceeded.
+	reached_set global_R(max_alpha, flags::OPT_MEMORY_LIMIT << 20);
+	global_R.insert(c_I, k);
 
 	/// <visible_R>: the sequences of set of visible configurations. We
 	/// compute the sequence from R directly.
@@ -66,27 +80,49 @@ bool explicit_wuba::k_bounded_reachability(const size_k k_bound,
 	/// step 2: compute all reachable configurations with up to k_bound write
 	while (k_bound == 0 || k <= k_bound) {
 		deque<explicit_state> nextRound;
+		/// the configurations generated and kept in this round, and the
+		/// number of images computed
+		ulong generated = 0, kept = 0, image_calls = 0;
 
 		/// step 2.1: compute nextLevel, or R_{k+1}: iterate over
 		while (!currRound.empty()) {
-			const auto tau = currRound.front();
-			currRound.pop_front();
-
-			const auto& k_images = step(tau);
-			for (const auto& _tau : k_images) {
-				/// add the successors to current round (R_{k}) if no write,
-				/// and to next round (R_{k+1}) otherwise.
-				if (_tau.get_state() == tau.get_state()) {
-					if (!update_R(_tau, k, global_R))
-						continue;
-					currRound.emplace_back(_tau);
-				} else {
-					if (!update_R(_tau, k + 1, global_R))
-						continue;
-					nextRound.emplace_back(_tau);
+			stats::timer t(stats::phase::EXPANSION, k);
+			/// spill the first k rounds if the memory limit is exceeded,
+			/// and drop the configurations reached there
+			global_R.spill(k);
+			global_R.filter(currRound);
+			deque<explicit_state> batch;
+			batch.swap(currRound);
+			for (const auto& tau : batch) {
+				const auto& k_images = step(tau);
+				++image_calls, generated += k_images.size();
+				for (const auto& _tau : k_images) {
+					/// add the successors to current round (R_{k}) if no
+					/// write, and to next round (R_{k+1}) otherwise.
+					if (_tau.get_state() == tau.get_state()) {
+						if (!global_R.insert(_tau, k))
+							continue;
+						++kept;
+						currRound.emplace_back(_tau);
+					} else {
+						if (!global_R.insert(_tau, k + 1))
+							continue;
+						++kept;
+						nextRound.emplace_back(_tau);
+					}
 				}
 			}
 		}
+		/// drop the configurations in R_{k+1} that were reached again with
+		/// k writes or in the spilled rounds
+		{
+			stats::timer t(stats::phase::EXPANSION, k);
+			global_R.compact(k + 1);
+			global_R.filter(nextRound);
+			global_R.purge();
+		}
+		stats::count(k, generated, kept, image_calls);
+		stats::set_frontier(k, nextRound.size());
 
 		/// step 2.2: convergence detection
 		/// 2.2.1: global_R collapses
@@ -98,7 +134,7 @@ bool explicit_wuba::k_bounded_reachability(const size_k k_bound,
 			cout << "======================================" << endl;
 		}
 		/// 2.2.2: top_R collapses
-		if (converge(global_R[k], k, top_R) || convergence_VS) {
+		if (converge(global_R, k, top_R) || convergence_VS) {
 			cout << "=> sequence T(R) collapses at ";
 			if (convergence_VS == 0)
 				convergence_VS = k == 0 ? k : k - 1;
@@ -132,36 +168,33 @@ deque<explicit_state> explicit_wuba::step(const explicit_state& tau) {
 	for (size_n tid = 0; tid < W.size(); ++tid) {
 		if (W[tid].empty())
 			continue;
-		const auto ifind = CPDA[tid].get_program().find(
-				thread_visible_state(q, W[tid].top()));
-		if (ifind == CPDA[tid].get_program().end())
-			continue;
-		for (const auto rid : ifind->second) { /// rid: transition id
-			const auto& r = CPDA[tid].get_actions()[rid];
-			const auto& dst = r.get_dst();
+		for (const auto& m : CPDA[tid].get_moves(q, W[tid].top())) {
 			auto _W = W;
-			switch (r.get_oper_type()) {
+			switch (m.op) {
 			case type_stack_operation::PUSH: { /// push operation
 				_W[tid].pop();
-				for (auto is = dst.get_stack().get_worklist().rbegin(), ie =
-						dst.get_stack().get_worklist().rend(); is != ie; ++is)
-					_W[tid].push(*is);
-				successors.emplace_back(dst.get_state(), _W);
+				_W[tid].push(m.below);
+				_W[tid].push(m.top);
+				successors.emplace_back(m.dst, _W);
 			}
 				break;
 			case type_stack_operation::POP: { /// pop operation
 				if (_W[tid].pop())
-					successors.emplace_back(dst.get_state(), _W);
+					successors.emplace_back(m.dst, _W);
 			}
 				break;
 			default: { /// overwrite operation
-				if (_W[tid].overwrite(dst.get_stack().top()))
-					successors.emplace_back(dst.get_state(), _W);
+				if (_W[tid].overwrite(m.top))
+					successors.emplace_back(m.dst, _W);
 			}
 				break;
 			}
 		}
 	}
+	if (!sym.empty()) {
+		for (auto& _tau : successors)
+			_tau = sym.canonicalize(_tau);
+	}
 	return successors;
 }
 
@@ -169,91 +202,40 @@ deque<explicit_state> explicit_wuba::step(const explicit_state& tau) {
  *
  * @param R
  * @param k
- * @param c
- * @return
- */
-bool explicit_wuba::update_R(const explicit_state& tau, const size_k k,
-		vector<vector<deque<explicit_state>>>& R) {
-	/// step 2.1.2: discard it if tau is already explored
-	if (is_reachable(tau, k, R))
-		return false;
-	if (k >= R.size())
-		R.emplace_back(vector<deque<explicit_state>>(thread_visible_state::S));
-	R[k][tau.get_state()].emplace_back(tau);
-	return true;
-}
-
-/**
- * This procedure is to determine whether there exists c \in R such that
- * (1) c.s == c.s /\ c.W == tau.W /\ c.k <= tau.k.
- * It returns true if any of above conditions satisfies. Otherwise, it
- * returns false.
- *
- * (2) One special case is that: there exists c \in R such that
- * c.s == tau.s /\ c.W == tau.W /\ c.k > tau.k, then, c is removed.
- *
- * In the implementation, we first check condition (1) and then (2).
- *
- * @param tau
- * @param k
- * @param R
- * @return bool
- */
-bool explicit_wuba::is_reachable(const explicit_state& tau, const size_k k,
-		vector<vector<deque<explicit_state>>>& R) {
-	/// step 1: retrieve the shared state of tau
-	const auto& q = tau.get_state();
-	/// step 2: check condition (2)
-	for (size_k j = k + 1; j < R.size(); ++j) {
-		for (auto it = R[j][q].begin(); it != R[j][q].end(); ++it) {
-			if (*it == tau)
-				R[j][q].erase(it);
-		}
-	}
-	/// step 3: check condition (1)
-	for (size_k j = 0; j <= k && j < R.size(); ++j) {
-		for (auto it = R[j][q].begin(); it != R[j][q].end(); ++it) {
-			if (*it == tau)
-				return true;
-		}
-	}
-	return false;
-}
-
-/**
- *
- * @param Rk
- * @param k
  * @param
  * @return
  */
-bool explicit_wuba::converge(const vector<deque<explicit_state>>& Rk,
-		const size_k k, vector<set<visible_state>>& top_R) {
+bool explicit_wuba::converge(const reached_set& R, const size_k k,
+		vector<set<visible_state>>& top_R) {
 	cout << "======================================\n";
 	cout << "write " << k << "\n";
 	/// the number of new reachable top configurations
 	uint cnt_new_top_cfg = 0;
-	for (pda_state q = 0; q < thread_visible_state::S; ++q) {
-		for (const auto& c : Rk[q]) {
-			if (flags::OPT_PRINT_ALL)
-				cout << string(2, ' ') << c;
-			const auto& top_c = top_mapping(c);
-			const auto& ret = top_R[c.get_state()].emplace(top_c);
-			if (ret.second) {
+	{
+		stats::timer t(stats::phase::TOP_MAPPING, k);
+		for (pda_state q = 0; q < thread_visible_state::S; ++q) {
+			for (const auto c : R.get_level(k)[q]) {
 				if (flags::OPT_PRINT_ALL)
-					cout << " : " << top_c;
-				++cnt_new_top_cfg;
-				/// removing reachable generators
-				auto ifind = generators[top_c.get_state()].find(top_c);
-				if (ifind != generators[top_c.get_state()].end())
-					generators[top_c.get_state()].erase(ifind);
+					cout << string(2, ' ') << R.unpack(*c);
+				const auto& top_c = top_mapping(R, *c);
+				const auto& ret = top_R[q].emplace(top_c);
+				if (ret.second) {
+					if (flags::OPT_PRINT_ALL)
+						cout << " : " << top_c;
+					++cnt_new_top_cfg;
+					/// removing reachable generators
+					auto ifind = generators[top_c.get_state()].find(top_c);
+					if (ifind != generators[top_c.get_state()].end())
+						generators[top_c.get_state()].erase(ifind);
+				}
+				if (flags::OPT_PRINT_ALL)
+					cout << "\n";
 			}
-			if (flags::OPT_PRINT_ALL)
-				cout << "\n";
 		}
 	}
 	cout << "the number of new visible states: " << cnt_new_top_cfg << "\n";
 	if (cnt_new_top_cfg == 0) {
+		stats::timer t(stats::phase::CONVERGENCE, k);
 		if (converge())
 			return true;
 		cout << "=> sequence T(R) plateaus at " << k << "\n";
@@ -276,16 +258,14 @@ bool explicit_wuba::converge() {
 }
 
 /**
- *
+ * Extract the visible state of a reached state
+ * @param R the reached set tau is stored in
  * @param tau
- * @return
+ * @return visible_state
  */
-visible_state explicit_wuba::top_mapping(const explicit_state& tau) {
-	vector<pda_alpha> W(tau.get_stacks().size());
-	for (size_n i = 0; i < tau.get_stacks().size(); ++i)
-		W[i] = tau.get_stacks()[i].empty() ?
-				alphabet::EPSILON : tau.get_stacks()[i].top();
-	return visible_state(tau.get_state(), W);
+visible_state explicit_wuba::top_mapping(const reached_set& R,
+		const packed_state& tau) {
+	return sym.canonicalize(R.top(tau));
 }
 
 } /* namespace wuba */
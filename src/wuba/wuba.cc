@@ -20,14 +20,34 @@ base_wuba::base_wuba(const string& initl, const string& final,
 		const string& filename) :
 		initl_c(0, 1), final_c(0, 1), CPDA(), ///
 		generators(), reachable_T(), ///
-		convergence_GS(0), convergence_VS(0) {
+		convergence_GS(0), convergence_VS(0), max_alpha(0) {
 	cout << "write-(un)bounded analysis......\n";
 
 	initl_c = parser::parse_input_cfg(initl);
 	final_c = parser::parse_input_cfg(final);
 	CPDA = parser::parse_input_cpds(filename);
 
+	/// the largest stack symbol decides how reached states are packed
+	auto bound = [this](const pda_alpha l) {
+		if (l != alphabet::EPSILON)
+			max_alpha = std::max(max_alpha, l);
+	};
+	for (const auto& P : CPDA) {
+		for (const auto l : P.get_alphas())
+			bound(l);
+		for (const auto& r : P.get_actions()) {
+			bound(r.get_src().get_alpha());
+			for (const auto l : r.get_dst().get_stack())
+				bound(l);
+		}
+	}
+	for (const auto& w : initl_c.get_stacks()) {
+		for (const auto l : w)
+			bound(l);
+	}
+
 	/// set up overapproximation of reachable top configurations
+	stats::timer t(stats::phase::GENERATOR);
 	generator gen(initl, CPDA, parser::parse_input_cfsm(filename));
 	generators = gen.get_generators();
 }
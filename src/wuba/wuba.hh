@@ -10,6 +10,8 @@
 
 #include <flags.hh>
 #include "generator.hh"
+#include "reached.hh"
+#include "stats.hh"
 
 using namespace ruba;
 
@@ -37,6 +39,9 @@ protected:
 
 	size_k convergence_GS; /// convergence of OS of global states
 	size_k convergence_VS; /// convergence of OS of visible states
+
+	/// the largest stack symbol, which decides how reached states are packed
+	pda_alpha max_alpha;
 };
 
 /////////////////////////////////////////////////////////////////////////
@@ -57,15 +62,14 @@ private:
 			const explicit_state& c_I);
 	deque<explicit_state> k_round(const deque<explicit_state>& R_k);
 	deque<explicit_state> step(const explicit_state& tau);
-	bool update_R(const explicit_state& tau, const size_k k,
-			vector<vector<deque<explicit_state>>>& R);
-	bool is_reachable(const explicit_state& tau, const size_k k,
-			vector<vector<deque<explicit_state>>>& R);
 
-	bool converge(const vector<deque<explicit_state>>& Rk, const size_k k,
+	bool converge(const reached_set& R, const size_k k,
 			vector<set<visible_state>>& top_R);
 	bool converge();
-	visible_state top_mapping(const explicit_state& tau);
+	visible_state top_mapping(const reached_set& R, const packed_state& tau);
+
+	/// the interchangeable threads, if symmetry reduction is enabled
+	symmetry sym;
 };
 
 /////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,88 @@
+#!/bin/bash
+#
+# Run the example-driven tests listed in test/cases.txt, from the root of
+# the repository:
+#
+#   test/run.sh [bin/cuba] [--update]
+#
+# Each case runs cuba with --stats json, and keeps the lines starting with
+# "=>", the interchangeable threads, the numbers of reachable states, the
+# generated and kept states of each level, and the states of the automata
+# before and after minimization in the symbolic exploration. --update
+# writes them to test/expected instead of comparing them.
+
+BIN=bin/cuba
+UPDATE=0
+for arg in "$@"; do
+	case $arg in
+	--update) UPDATE=1 ;;
+	*) BIN=$arg ;;
+	esac
+done
+
+DIR=$(dirname "$0")
+OUT=$(mktemp -d)
+trap 'rm -rf "$OUT"' EXIT
+
+# the results and the counts of a run
+digest() {
+	awk '
+	/^\{"engine"/ {
+		symbolic = index($0, "\"engine\": \"symbolic") > 0
+		s = $0
+		while (match(s, /"(level|generated|kept|before|after)": [0-9]+/)) {
+			kv = substr(s, RSTART, RLENGTH)
+			s = substr(s, RSTART + RLENGTH)
+			gsub(/[":]/, "", kv)
+			split(kv, a, " ")
+			if (a[1] == "level")
+				k = a[2]
+			else if (a[1] == "before" || a[1] == "after") {
+				if (symbolic)
+					print "level " k " minimized_" a[1] " " a[2]
+			}
+			else
+				print "level " k " " a[1] " " a[2]
+		}
+		next
+	}
+	/^=>|^interchangeable threads|^The number of reachable/ { print }
+	'
+}
+
+pass=0
+fail=0
+while read -r kind name rest; do
+	case $kind in
+	run)
+		read -r example options <<< "$rest"
+		timeout 300 "$BIN" -f "$example.pds" -i "$example.init" $options \
+			-S json 2>&1 | digest > "$OUT/$name"
+		if [ $UPDATE -eq 1 ]; then
+			cp "$OUT/$name" "$DIR/expected/$name"
+			continue
+		fi
+		if diff -u "$DIR/expected/$name" "$OUT/$name" > "$OUT/$name.diff"; then
+			pass=$((pass + 1))
+		else
+			fail=$((fail + 1))
+			echo "FAIL $name"
+			cat "$OUT/$name.diff"
+		fi
+		;;
+	same)
+		read -r base pattern <<< "$rest"
+		if diff <(grep -E "$pattern" "$OUT/$base") \
+			<(grep -E "$pattern" "$OUT/$name") > "$OUT/$name.same"; then
+			pass=$((pass + 1))
+		else
+			fail=$((fail + 1))
+			echo "FAIL $name differs from $base on /$pattern/"
+			cat "$OUT/$name.same"
+		fi
+		;;
+	esac
+done < <(grep -v '^\s*\(#\|$\)' "$DIR/cases.txt")
+
+echo "passed: $pass, failed: $fail"
+[ $fail -eq 0 ]
@@ -0,0 +1,92 @@
+/**
+ * subsumption.cc
+ *
+ * @date  : Oct 18, 2026
+ * @author: TODO
+ */
+
+#include "cuba.hh"
+
+using namespace cuba;
+
+/// the number of checks passed and failed
+static uint passed = 0, failed = 0;
+
+/**
+ * Record a check
+ * @param name
+ * @param holds
+ */
+static void check(const string& name, const bool holds) {
+	if (holds) {
+		++passed;
+	} else {
+		++failed;
+		cout << "FAIL " << name << "\n";
+	}
+}
+
+/**
+ * Build a store automaton from control state 0 with accept state 2
+ * @param transitions
+ * @return store_automaton
+ */
+static store_automaton build(const vector<fsa_transition>& transitions) {
+	fsa_state_set states { 0, 2 };
+	fsa_alphabet alphabet;
+	fsa_delta delta;
+	for (const auto& r : transitions) {
+		states.emplace(r.get_dst());
+		if (r.get_label() != alphabet::EPSILON)
+			alphabet.emplace(r.get_label());
+		delta.insert(r);
+	}
+	return store_automaton(states, alphabet, delta, { 0 }, 2);
+}
+
+/**
+ * Check the subsumption of symbolic states, which drops the reached ones
+ * whose canonical forms differ from the ones kept, on automata accepting
+ * the same stacks, ab and ac, with different shapes
+ */
+int main(const int argc, const char * const * const argv) {
+	thread_visible_state::S = 1;
+	const pda_alpha a = 1, b = 2, c = 3;
+	const auto eps = alphabet::EPSILON;
+	/// deterministic
+	const auto A1 = build( { { 0, 1, a }, { 1, 2, b }, { 1, 2, c } });
+	/// nondeterministic, one branch per stack
+	const auto A2 = build( { { 0, 1, a }, { 0, 3, a }, { 1, 2, b },
+			{ 3, 2, c } });
+	/// with an epsilon transition from the control state
+	const auto A3 = build( { { 0, 4, eps }, { 4, 1, a }, { 1, 2, b },
+			{ 1, 2, c } });
+	/// a smaller language: ab
+	const auto B = build( { { 0, 1, a }, { 1, 2, b } });
+
+	const vector<store_automaton> W { A1, A2, A3 };
+	for (size_t i = 0; i < W.size(); ++i) {
+		for (size_t j = 0; j < W.size(); ++j) {
+			if (i == j)
+				continue;
+			const auto& name = "A" + std::to_string(i + 1) + " A"
+					+ std::to_string(j + 1);
+			check("different shapes " + name,
+					W[i].get_canonical_form() != W[j].get_canonical_form());
+			check("same language " + name,
+					symbolic_cuba::is_included(W[i], W[j]));
+			check("subsumed " + name,
+					symbolic_cuba::is_subsumed(symbolic_state(0, { W[i] }),
+							symbolic_state(0, { W[j] })));
+		}
+		check("smaller language in A" + std::to_string(i + 1),
+				symbolic_cuba::is_included(B, W[i]));
+		check("larger language A" + std::to_string(i + 1),
+				!symbolic_cuba::is_included(W[i], B));
+		check("not subsumed by smaller language A" + std::to_string(i + 1),
+				!symbolic_cuba::is_subsumed(symbolic_state(0, { W[i] }),
+						symbolic_state(0, { B })));
+	}
+	cout << "passed: " << passed << ", failed: " << failed << "\n";
+	return failed == 0 ? 0 : 1;
+}